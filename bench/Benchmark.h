@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_BENCH_BENCHMARK_H
+#define FBXCONV_BENCH_BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include "../src/util/timer.h"
+
+namespace fbxconv {
+namespace bench {
+	/** A deterministic pseudo random generator (xorshift), so every run uses the same synthetic data */
+	struct Random {
+		unsigned int state;
+
+		Random(const unsigned int &seed = 0x9E3779B9) : state(seed ? seed : 1) {}
+
+		inline unsigned int next() {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+
+		/** A value from 0 (inclusive) to n (exclusive) */
+		inline unsigned int next(const unsigned int &n) {
+			return next() % n;
+		}
+
+		/** A value from min to max */
+		inline float next(const float &min, const float &max) {
+			return min + (max - min) * (float)(next() & 0xFFFFFF) / (float)0xFFFFFF;
+		}
+	};
+
+	/** The timings of the samples of a benchmark or stage, in seconds */
+	struct Statistics {
+		std::vector<double> samples;
+
+		inline void add(const double &seconds) {
+			samples.push_back(seconds);
+		}
+
+		/** The sample at p (0 to 1) of the sorted samples, using the nearest rank */
+		double percentile(const double &p) const {
+			if (samples.empty())
+				return 0.;
+			std::vector<double> sorted(samples);
+			std::sort(sorted.begin(), sorted.end());
+			const size_t rank = (size_t)(p * (double)sorted.size() + 0.5);
+			return sorted[rank == 0 ? 0 : (rank > sorted.size() ? sorted.size() - 1 : rank - 1)];
+		}
+
+		inline double median() const {
+			return percentile(0.5);
+		}
+
+		inline double p95() const {
+			return percentile(0.95);
+		}
+	};
+
+	/** A benchmark of a single kernel. The data is generated in setup(), which isn't part of the measurement. */
+	struct Benchmark {
+		const char *name;
+		/** The number of items and bytes processed by a single call to run() */
+		double items, bytes;
+
+		Benchmark(const char * const &name) : name(name), items(0.), bytes(0.) {}
+
+		virtual ~Benchmark() {}
+
+		/** Called before each sample */
+		virtual void setup() {}
+
+		/** The measured code */
+		virtual void run() = 0;
+
+		/** Called after each sample */
+		virtual void teardown() {}
+
+		/** Run the benchmark once to warm up, then until both the minimum number of samples and time are reached */
+		Statistics measure(const unsigned int &minSamples = 5, const double &minTime = 1.) {
+			Statistics result;
+			setup();
+			run();
+			teardown();
+			double total = 0.;
+			while (result.samples.size() < minSamples || total < minTime) {
+				setup();
+				util::Timer timer;
+				run();
+				const double elapsed = timer.elapsed();
+				teardown();
+				result.add(elapsed);
+				total += elapsed;
+			}
+			return result;
+		}
+	};
+
+	/** Prevents the compiler from removing a computation of which the result would otherwise be unused */
+	inline void consume(const unsigned int &value) {
+		static volatile unsigned int sink = 0;
+		sink += value;
+	}
+
+	/** Print a human readable amount per second, e.g. 1.23 M/s */
+	inline void printRate(const double &amount, const double &seconds, const char * const &unit) {
+		static const char *prefixes[] = {"", "k", "M", "G", "T"};
+		double rate = seconds > 0. ? amount / seconds : 0.;
+		int prefix = 0;
+		while (rate >= 1000. && prefix < 4) {
+			rate /= 1000.;
+			prefix++;
+		}
+		printf("%8.2f %s%s/s", rate, prefixes[prefix], unit);
+	}
+}
+}
+
+#endif //FBXCONV_BENCH_BENCHMARK_H
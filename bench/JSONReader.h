@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_BENCH_JSONREADER_H
+#define FBXCONV_BENCH_JSONREADER_H
+
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+
+namespace fbxconv {
+namespace bench {
+	/** A parsed JSON value, only meant for reading small files like the benchmark baseline */
+	struct JSONValue {
+		enum Type { Null, Boolean, Number, String, Array, Object };
+
+		Type type;
+		double number;
+		std::string string;
+		/** The items of an array or the values of an object */
+		std::vector<JSONValue> items;
+		/** The keys of an object, in the same order as the items */
+		std::vector<std::string> keys;
+
+		JSONValue() : type(Null), number(0.) {}
+
+		/** The value of the key if this is an object containing the key, otherwise null */
+		const JSONValue *get(const std::string &key) const {
+			for (size_t i = 0; i < keys.size(); i++)
+				if (keys[i] == key)
+					return &items[i];
+			return 0;
+		}
+
+		double getNumber(const std::string &key, const double &def = 0.) const {
+			const JSONValue *value = get(key);
+			return value != 0 && value->type == Number ? value->number : def;
+		}
+
+		std::string getString(const std::string &key) const {
+			const JSONValue *value = get(key);
+			return value != 0 && value->type == String ? value->string : std::string();
+		}
+
+		/** Parse the text, returns false if it isn't valid JSON */
+		bool parse(const std::string &text) {
+			const char *p = text.c_str();
+			return parse(p) && *skip(p) == 0;
+		}
+
+	private:
+		static const char *skip(const char *&p) {
+			while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+				p++;
+			return p;
+		}
+
+		static bool parseString(const char *&p, std::string &out) {
+			out.clear();
+			for (p++; *p != '"'; p++) {
+				if (*p == 0)
+					return false;
+				if (*p != '\\') {
+					out += *p;
+					continue;
+				}
+				switch (*(++p)) {
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				case 't': out += '\t'; break;
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'u': // Only ASCII is expected, other characters are replaced
+					for (int i = 0; i < 4; i++)
+						if (*(++p) == 0)
+							return false;
+					out += '?';
+					break;
+				case 0: return false;
+				default: out += *p; break;
+				}
+			}
+			p++;
+			return true;
+		}
+
+		bool parse(const char *&p) {
+			switch (*skip(p)) {
+			case '{':
+				type = Object;
+				for (p++; *skip(p) != '}'; ) {
+					keys.push_back(std::string());
+					items.push_back(JSONValue());
+					if (*p != '"' || !parseString(p, keys.back()) || *skip(p) != ':' || !items.back().parse(++p))
+						return false;
+					if (*skip(p) == ',')
+						p++;
+					else if (*p != '}')
+						return false;
+				}
+				p++;
+				return true;
+			case '[':
+				type = Array;
+				for (p++; *skip(p) != ']'; ) {
+					items.push_back(JSONValue());
+					if (!items.back().parse(p))
+						return false;
+					if (*skip(p) == ',')
+						p++;
+					else if (*p != ']')
+						return false;
+				}
+				p++;
+				return true;
+			case '"':
+				type = String;
+				return parseString(p, string);
+			case 't':
+			case 'f':
+			case 'n': {
+				static const char *words[] = {"true", "false", "null"};
+				for (int i = 0; i < 3; i++) {
+					const size_t n = strlen(words[i]);
+					if (strncmp(p, words[i], n) == 0) {
+						type = i < 2 ? Boolean : Null;
+						number = i == 0 ? 1. : 0.;
+						p += n;
+						return true;
+					}
+				}
+				return false;
+			}
+			default: {
+				char *end;
+				number = strtod(p, &end);
+				if (end == p)
+					return false;
+				type = Number;
+				p = end;
+				return true;
+			}
+			}
+		}
+	};
+}
+}
+
+#endif //FBXCONV_BENCH_JSONREADER_H
@@ -0,0 +1,268 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+/** Microbenchmarks of the hot kernels of the converter, using synthetic data so no source files are needed.
+ * Usage: fbx-conv-bench [-t <seconds>] [<filter>], only the benchmarks whose name contains the filter are run. */
+#include <sstream>
+#include <stdlib.h>
+#include "Benchmark.h"
+#include "../src/modeldata/Mesh.h"
+#include "../src/modeldata/Attributes.h"
+#include "../src/json/JSONWriter.h"
+#include "../src/json/UBJSONWriter.h"
+#include "../src/readers/util.h"
+#include "../src/readers/FbxConverter.h"
+#include "../src/log/messages.h"
+
+using namespace fbxconv;
+using namespace fbxconv::bench;
+using namespace fbxconv::modeldata;
+
+/** Adds a stream of triangle vertices, in which each unique vertex is referenced about six times */
+struct MeshAddBenchmark : public Benchmark {
+	const bool weld;
+	const unsigned int uniqueCount;
+	std::vector<float> stream;
+	Mesh *mesh;
+
+	MeshAddBenchmark(const char * const &name, const bool &weld, const unsigned int &uniqueCount)
+		: Benchmark(name), weld(weld), uniqueCount(uniqueCount), mesh(0) {
+		Random random;
+		std::vector<float> unique;
+		for (unsigned int i = 0; i < uniqueCount; i++) {
+			const float vertex[8] = {random.next(-10.f, 10.f), random.next(-10.f, 10.f), random.next(-10.f, 10.f), 0.f, 1.f, 0.f, random.next(0.f, 1.f), random.next(0.f, 1.f)};
+			unique.insert(unique.end(), vertex, vertex + 8);
+		}
+		for (unsigned int i = 0; i < uniqueCount * 6; i++) {
+			const unsigned int index = (i / 3 + (i % 3) * 17) % uniqueCount;
+			stream.insert(stream.end(), &unique[index * 8], &unique[index * 8 + 8]);
+		}
+		items = (double)(stream.size() / 8);
+		bytes = (double)(stream.size() * sizeof(float));
+	}
+
+	virtual void setup() {
+		mesh = new Mesh();
+		mesh->attributes.hasPosition(true);
+		mesh->attributes.hasNormal(true);
+		mesh->attributes.hasUV(0, true);
+		mesh->vertexSize = mesh->attributes.size();
+		if (weld)
+			mesh->setWeldTolerance(WeldTolerance(0.0001f, 1.f, 0.0001f, 0.002f));
+	}
+
+	virtual void run() {
+		unsigned int result = 0;
+		for (size_t i = 0; i < stream.size(); i += 8)
+			result += mesh->add(&stream[i]);
+		consume(result);
+	}
+
+	virtual void teardown() {
+		delete mesh;
+		mesh = 0;
+	}
+};
+
+struct CalcHashBenchmark : public Benchmark {
+	std::vector<float> vertices;
+	Mesh mesh;
+
+	CalcHashBenchmark() : Benchmark("Mesh::calcHash") {
+		Random random;
+		vertices.resize(1000000 * 8);
+		for (std::vector<float>::iterator itr = vertices.begin(); itr != vertices.end(); ++itr)
+			*itr = random.next(-100.f, 100.f);
+		items = (double)(vertices.size() / 8);
+		bytes = (double)(vertices.size() * sizeof(float));
+	}
+
+	virtual void run() {
+		unsigned int result = 0;
+		for (size_t i = 0; i < vertices.size(); i += 8)
+			result += mesh.calcHash(&vertices[i], 8);
+		consume(result);
+	}
+};
+
+/** Assigns the bones of the triangles of a skinned mesh with 64 bones to groups of 12 bones */
+struct BlendBonesBenchmark : public Benchmark {
+	std::vector<std::vector<readers::BlendWeight> > weights;
+	std::vector<std::vector<std::vector<readers::BlendWeight>*> > triangles;
+
+	BlendBonesBenchmark() : Benchmark("BlendBonesCollection::add") {
+		Random random;
+		const unsigned int count = 20000;
+		weights.resize(count * 3);
+		for (unsigned int i = 0; i < count * 3; i++) {
+			// Neighbouring vertices are influenced by neighbouring bones
+			const int base = (int)((i / 3) * 60 / count);
+			for (int j = 0; j < 4; j++)
+				weights[i].push_back(readers::BlendWeight(random.next(0.f, 1.f), base + (int)random.next(5)));
+		}
+		triangles.resize(count);
+		for (unsigned int i = 0; i < count; i++)
+			for (unsigned int j = 0; j < 3; j++)
+				triangles[i].push_back(&weights[i * 3 + j]);
+		items = (double)count;
+	}
+
+	virtual void run() {
+		readers::BlendBonesCollection collection(12);
+		unsigned int result = 0;
+		for (std::vector<std::vector<std::vector<readers::BlendWeight>*> >::const_iterator itr = triangles.begin(); itr != triangles.end(); ++itr)
+			result += collection.add(*itr);
+		consume(result + collection.size());
+	}
+};
+
+/** Reduces the sampled keyframes of bones which are partly linear and partly curved */
+struct KeyframesBenchmark : public Benchmark {
+	static const unsigned int ANIMATIONS = 100;
+	static const unsigned int FRAMES = 300;
+	log::Log log;
+	readers::FbxConverter converter;
+	Node node;
+	std::vector<std::vector<Keyframe> > frames;
+	std::vector<NodeAnimation *> animations;
+
+	KeyframesBenchmark() : Benchmark("FbxConverter::addKeyframes"), log(new log::DefaultMessages(), 0), converter(&log, 0) {
+		items = (double)(ANIMATIONS * FRAMES);
+	}
+
+	virtual void setup() {
+		frames.resize((size_t)ANIMATIONS);
+		for (unsigned int i = 0; i < ANIMATIONS; i++) {
+			frames[i].resize((size_t)FRAMES);
+			for (unsigned int j = 0; j < FRAMES; j++) {
+				Keyframe * const keyframe = &frames[i][j];
+				const float t = (float)j / (float)FRAMES;
+				keyframe->time = (float)j * 1000.f / 30.f;
+				keyframe->translation[0] = t * (float)i;
+				keyframe->translation[1] = j < FRAMES / 2 ? 0.f : (float)sin(t * 6.f);
+				const float angle = (float)(i % 4) * t;
+				keyframe->rotation[1] = (float)sin(angle);
+				keyframe->rotation[3] = (float)cos(angle);
+			}
+			animations.push_back(new NodeAnimation());
+			animations.back()->node = &node;
+		}
+	}
+
+	virtual void run() {
+		unsigned int result = 0;
+		for (unsigned int i = 0; i < ANIMATIONS; i++) {
+			converter.addKeyframes(animations[i], frames[i]);
+			result += (unsigned int)animations[i]->keyframeCount();
+		}
+		consume(result);
+	}
+
+	virtual void teardown() {
+		for (std::vector<NodeAnimation *>::iterator itr = animations.begin(); itr != animations.end(); ++itr)
+			delete *itr;
+		animations.clear();
+		frames.clear();
+	}
+};
+
+/** Writes a large array of vertex data, like the vertices of a mesh */
+template<class Writer> struct WriterBenchmark : public Benchmark {
+	std::vector<float> values;
+	std::ostringstream stream;
+
+	WriterBenchmark(const char * const &name) : Benchmark(name) {
+		Random random;
+		values.resize(1000000);
+		for (std::vector<float>::iterator itr = values.begin(); itr != values.end(); ++itr)
+			*itr = random.next(-100.f, 100.f);
+		items = (double)values.size();
+		bytes = (double)(values.size() * sizeof(float));
+	}
+
+	virtual void setup() {
+		stream.str("");
+	}
+
+	virtual void run() {
+		Writer writer(stream);
+		writer.obj(1);
+		writer.val("vertices").is().data(values);
+		writer.end();
+		consume((unsigned int)stream.tellp());
+	}
+};
+
+/** Queries the size and the type of each value of the vertex of a skinned mesh with two uv channels */
+struct AttributesBenchmark : public Benchmark {
+	static const unsigned int COUNT = 1000000;
+	Attributes attributes;
+
+	AttributesBenchmark() : Benchmark("Attributes::size/getType") {
+		attributes.hasPosition(true);
+		attributes.hasNormal(true);
+		attributes.hasColor(true);
+		attributes.hasUV(0, true);
+		attributes.hasUV(1, true);
+		for (unsigned int i = 0; i < 4; i++)
+			attributes.hasBlendWeight(i, true);
+		items = (double)COUNT;
+	}
+
+	virtual void run() {
+		unsigned int result = 0;
+		for (unsigned int i = 0; i < COUNT; i++) {
+			const unsigned int size = attributes.size();
+			result += size + attributes.getType(i % size);
+		}
+		consume(result);
+	}
+};
+
+int main(int argc, const char** argv) {
+	double minTime = 1.;
+	const char *filter = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			minTime = atof(argv[++i]);
+		else
+			filter = argv[i];
+	}
+
+	std::vector<Benchmark *> benchmarks;
+	benchmarks.push_back(new MeshAddBenchmark("Mesh::add", false, 4000));
+	benchmarks.push_back(new MeshAddBenchmark("Mesh::add (weld)", true, 50000));
+	benchmarks.push_back(new CalcHashBenchmark());
+	benchmarks.push_back(new BlendBonesBenchmark());
+	benchmarks.push_back(new KeyframesBenchmark());
+	benchmarks.push_back(new WriterBenchmark<json::JSONWriter>("JSONWriter::data"));
+	benchmarks.push_back(new WriterBenchmark<json::UBJSONWriter>("UBJSONWriter::data"));
+	benchmarks.push_back(new AttributesBenchmark());
+
+	printf("%-28s %10s %10s %14s %14s\n", "benchmark", "median ms", "p95 ms", "items", "bytes");
+	for (std::vector<Benchmark *>::iterator itr = benchmarks.begin(); itr != benchmarks.end(); ++itr) {
+		if (filter == 0 || strstr((*itr)->name, filter) != 0) {
+			const Statistics statistics = (*itr)->measure(5, minTime);
+			const double median = statistics.median();
+			printf("%-28s %10.3f %10.3f ", (*itr)->name, median * 1000., statistics.p95() * 1000.);
+			printRate((*itr)->items, median, "");
+			if ((*itr)->bytes > 0.)
+				printRate((*itr)->bytes, median, "B");
+			printf("\n");
+		}
+		delete *itr;
+	}
+	return 0;
+}
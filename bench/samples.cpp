@@ -0,0 +1,284 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+/** End-to-end benchmark of the converter. Each sample is converted to each output type with each set of key options
+ * several times in-process using FbxConv::execute. The stages are timed using the status messages of the log and the
+ * results can be written to and compared against a baseline file.
+ * Usage: fbx-conv-bench-samples [options] [<sample>...]
+ *   -s <dir>     : The directory containing the bundled samples (default: samples)
+ *   -n <runs>    : The number of conversions per case (default: 5)
+ *   -f <filter>  : Only run the cases of which the name contains the filter
+ *   -o <file>    : Write the results to the JSON file, which can be used as baseline
+ *   -c <file>    : Compare the results against the baseline JSON file
+ *   -x <percent> : The allowed slowdown (and output size increase) before it's reported as a regression (default: 10)
+ * Returns 1 if a conversion failed or a regression is found, 0 otherwise. */
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "Benchmark.h"
+#include "JSONReader.h"
+#include "../src/FbxConv.h"
+#include "../src/log/messages.h"
+
+using namespace fbxconv;
+using namespace fbxconv::bench;
+
+/** The bundled samples, relative to the samples directory */
+static const char *bundledSamples[] = {
+	"knight.fbx",
+	"3dsmax/animation.FBX", "3dsmax/animation_bin.FBX", "3dsmax/redSpec.fbx", "3dsmax/redSpec_bin.fbx",
+	"3dsmax/textured.FBX", "3dsmax/textured_bin.FBX",
+	"blender/cube.fbx", "blender/cube.obj", "blender/cubes.fbx", "blender/cube-single-bone.fbx",
+	"blender/cube-two-bones.fbx", "blender/WoodenBoxOpen02.fbx",
+	"softimage/cube_anim.fbx", "softimage/cube_anim_2clips.fbx", "softimage/cube_anim_2clips_ascii.fbx",
+	"softimage/cube_anim_linear.fbx", "softimage/cube_multi_uv.fbx", "softimage/cube_single_uv.fbx",
+	"softimage/cube_single_uv_bump.fbx", "softimage/cube_single_uv_flipped.fbx",
+	"softimage/cube_single_uv_multi_material.fbx", "softimage/head.fbx", "softimage/head2.fbx",
+	"softimage/head_parented.fbx"
+};
+
+static const char *outputTypes[] = {"g3db", "g3dj", "g3dm"};
+
+/** The key options which influence the conversion the most, each is benchmarked separately */
+static const char *optionSets[] = {"", "-p", "-b 24", "-w 8", "-m 4096"};
+
+enum Stage { STAGE_PARSE, STAGE_LOAD, STAGE_CONVERT, STAGE_SAVE, STAGE_TOTAL, STAGE_COUNT };
+static const char *stageNames[STAGE_COUNT] = {"parse", "load", "convert", "save", "total"};
+
+/** Records the time of each status message instead of printing it, other messages are printed as usual */
+class StageLog : public log::Log {
+public:
+	std::vector<double> times;
+
+	StageLog() : log::Log(new log::DefaultMessages(), LOG_STATUS | LOG_ERROR), times(log::num_codes, -1.) {}
+
+	void reset() {
+		times.assign(log::num_codes, -1.);
+	}
+
+	virtual void vlog(const int &type, const int &code, va_list vl) {
+		if (type == LOG_STATUS)
+			times[code] = util::seconds();
+		else
+			log::Log::vlog(type, code, vl);
+	}
+
+	/** The time between the two status messages, or a negative value if either one wasn't logged */
+	double elapsed(const int &from, const int &to) const {
+		return times[from] < 0. || times[to] < 0. ? -1. : times[to] - times[from];
+	}
+};
+
+struct Case : public json::ConstSerializable {
+	std::string sample, type, options, name;
+	Statistics stages[STAGE_COUNT];
+	unsigned long size;
+	bool failed;
+
+	Case(const std::string &sample, const std::string &type, const std::string &options)
+		: sample(sample), type(type), options(options), size(0), failed(false) {
+		name = sample + " " + type + (options.empty() ? "" : " ") + options;
+	}
+
+	/** Convert the sample once, returns false if the conversion failed */
+	bool run(StageLog &log, const std::string &input, const std::string &output) {
+		std::vector<std::string> args;
+		args.push_back("fbx-conv");
+		std::istringstream ss(options);
+		for (std::string option; ss >> option; )
+			args.push_back(option);
+		args.push_back("-o");
+		args.push_back(type);
+		args.push_back(input);
+		args.push_back(output);
+		std::vector<const char *> argv;
+		for (std::vector<std::string>::const_iterator itr = args.begin(); itr != args.end(); ++itr)
+			argv.push_back(itr->c_str());
+
+		log.reset();
+		const double start = util::seconds();
+		FbxConv conv(&log);
+		const bool result = conv.execute((int)argv.size(), &argv[0]);
+		const double end = util::seconds();
+		const int exportCode = type == "g3dj" ? log::sExportToG3DJ : (type == "g3dm" ? log::sExportToG3DM : log::sExportToG3DB);
+		const double times[STAGE_COUNT] = {
+			log.times[log::sSourceLoad] < 0. ? -1. : log.times[log::sSourceLoad] - start,
+			log.elapsed(log::sSourceLoad, log::sSourceConvert),
+			log.elapsed(log::sSourceConvert, log::sSourceClose),
+			// Includes closing the file, which is where the buffered output is actually written
+			log.times[exportCode] < 0. ? -1. : end - log.times[exportCode],
+			end - start
+		};
+		for (int i = 0; i < STAGE_COUNT; i++) {
+			if (times[i] < 0.)
+				return false;
+			stages[i].add(times[i]);
+		}
+		struct stat info;
+		if (!result || stat(output.c_str(), &info) != 0)
+			return false;
+		size = (unsigned long)info.st_size;
+		return true;
+	}
+
+	virtual void serialize(json::BaseJSONWriter &writer) const {
+		writer << json::obj;
+		writer << "sample" = sample;
+		writer << "type" = type;
+		writer << "options" = options;
+		writer << "failed" = failed;
+		writer << "runs" = (unsigned int)stages[STAGE_TOTAL].samples.size();
+		writer << "size" = size;
+		writer.val("stages").is().obj(STAGE_COUNT);
+		for (int i = 0; i < STAGE_COUNT; i++) {
+			writer.val(stageNames[i]).is().obj(2);
+			writer << "median" = stages[i].median() * 1000.;
+			writer << "p95" = stages[i].p95() * 1000.;
+			writer.end();
+		}
+		writer.end();
+		writer << json::end;
+	}
+};
+
+static bool readFile(const char * const &filename, std::string &out) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+		return false;
+	std::stringstream ss;
+	ss << file.rdbuf();
+	out = ss.str();
+	return true;
+}
+
+/** Compare the case against its baseline, returns the number of regressions */
+static int compare(const Case &current, const JSONValue &baseline, const double &threshold) {
+	// Differences below half a millisecond are considered noise
+	static const double minimumDifference = 0.5;
+	int result = 0;
+	const JSONValue *stages = baseline.get("stages");
+	for (int i = 0; stages != 0 && i < STAGE_COUNT; i++) {
+		const JSONValue *stage = stages->get(stageNames[i]);
+		if (stage == 0)
+			continue;
+		const double before = stage->getNumber("median"), after = current.stages[i].median() * 1000.;
+		if (after > before * (1. + threshold) && after - before > minimumDifference) {
+			printf("REGRESSION: %s %s: %.3f ms -> %.3f ms (%+.1f%%)\n", current.name.c_str(), stageNames[i], before, after, (after / before - 1.) * 100.);
+			result++;
+		}
+	}
+	const double before = baseline.getNumber("size"), after = (double)current.size;
+	if (after > before * (1. + threshold)) {
+		printf("REGRESSION: %s size: %.0f -> %.0f bytes (%+.1f%%)\n", current.name.c_str(), before, after, (after / before - 1.) * 100.);
+		result++;
+	}
+	return result;
+}
+
+int main(int argc, const char** argv) {
+	std::string samplesDir = "samples", outFile, baselineFile;
+	const char *filter = 0;
+	unsigned int runs = 5;
+	double threshold = 10.;
+	std::vector<std::string> samples;
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (arg[0] == '-' && arg[1] != 0 && arg[2] == 0 && i + 1 < argc) {
+			const char *value = argv[++i];
+			switch (arg[1]) {
+			case 's': samplesDir = value; break;
+			case 'n': runs = (unsigned int)atoi(value); break;
+			case 'f': filter = value; break;
+			case 'o': outFile = value; break;
+			case 'c': baselineFile = value; break;
+			case 'x': threshold = atof(value); break;
+			default: printf("Unknown option: %s\n", arg); return 1;
+			}
+		}
+		else
+			samples.push_back(arg);
+	}
+	if (runs < 1)
+		runs = 1;
+	if (samples.empty())
+		for (unsigned int i = 0; i < sizeof(bundledSamples) / sizeof(bundledSamples[0]); i++)
+			samples.push_back(samplesDir + "/" + bundledSamples[i]);
+
+	JSONValue baseline;
+	if (!baselineFile.empty()) {
+		std::string text;
+		if (!readFile(baselineFile.c_str(), text) || !baseline.parse(text) || baseline.get("results") == 0) {
+			printf("Unable to read baseline file '%s'\n", baselineFile.c_str());
+			return 1;
+		}
+	}
+
+	std::vector<Case *> cases;
+	for (std::vector<std::string>::const_iterator itr = samples.begin(); itr != samples.end(); ++itr)
+		for (unsigned int t = 0; t < sizeof(outputTypes) / sizeof(outputTypes[0]); t++)
+			for (unsigned int o = 0; o < sizeof(optionSets) / sizeof(optionSets[0]); o++) {
+				Case *c = new Case(*itr, outputTypes[t], optionSets[o]);
+				if (filter == 0 || c->name.find(filter) != std::string::npos)
+					cases.push_back(c);
+				else
+					delete c;
+			}
+
+	StageLog log;
+	int failures = 0, regressions = 0;
+	printf("%-56s %10s", "case", "size");
+	for (int i = 0; i < STAGE_COUNT; i++)
+		printf(" %10s", stageNames[i]);
+	printf(" %10s\n", "total p95");
+	for (std::vector<Case *>::iterator itr = cases.begin(); itr != cases.end(); ++itr) {
+		Case &c = **itr;
+		const std::string output = "fbx-conv-bench-output." + c.type;
+		for (unsigned int i = 0; i < runs && !c.failed; i++)
+			c.failed = !c.run(log, c.sample, output);
+		remove(output.c_str());
+		if (c.failed) {
+			printf("FAILED: %s\n", c.name.c_str());
+			failures++;
+			continue;
+		}
+		printf("%-56s %10lu", c.name.c_str(), c.size);
+		for (int i = 0; i < STAGE_COUNT; i++)
+			printf(" %10.3f", c.stages[i].median() * 1000.);
+		printf(" %10.3f\n", c.stages[STAGE_TOTAL].p95() * 1000.);
+
+		const JSONValue *results = baseline.get("results");
+		for (size_t i = 0; results != 0 && i < results->items.size(); i++) {
+			const JSONValue &base = results->items[i];
+			if (base.getString("sample") == c.sample && base.getString("type") == c.type && base.getString("options") == c.options) {
+				regressions += compare(c, base, threshold / 100.);
+				break;
+			}
+		}
+	}
+	printf("%d cases, %d failed, %d regressions (times in ms, median of %u runs)\n", (int)cases.size(), failures, regressions, runs);
+
+	if (!outFile.empty()) {
+		std::ofstream file(outFile.c_str(), std::ios::binary);
+		json::JSONWriter writer(file);
+		writer << json::obj;
+		writer << "runs" = runs;
+		writer << "results" = cases;
+		writer << json::end;
+	}
+	for (std::vector<Case *>::iterator itr = cases.begin(); itr != cases.end(); ++itr)
+		delete *itr;
+	return failures > 0 || regressions > 0 ? 1 : 0;
+}
@@ -12,13 +12,26 @@
 
 FBX_SDK_ROOT = os.getenv("FBX_SDK_ROOT")
 if not FBX_SDK_ROOT then
-	printf("ERROR: Environment variable FBX_SDK_ROOT is not set.")
+	printf("WARNING: Environment variable FBX_SDK_ROOT is not set, building without the FBX SDK (only OBJ files can be converted).")
 	printf("Set it to something like: C:\\Program Files\\Autodesk\\FBX\\FBX SDK\\2013.3")
-	os.exit()
+end
+
+-- returns the path within the FBX SDK, or the library name, or nothing when building without the FBX SDK
+function fbxsdk(value)
+	if not FBX_SDK_ROOT then
+		return {}
+	end
+	return value
+end
+function fbxsdkpath(path)
+	if not FBX_SDK_ROOT then
+		return {}
+	end
+	return FBX_SDK_ROOT .. path
 end
 
 -- avert your eyes children!
-if string.find(_ACTION, "xcode") then
+if FBX_SDK_ROOT and string.find(_ACTION, "xcode") then
 	-- TODO: i'm sure we could do some string search+replace trickery to make 
 	--       this more general-purpose
 	-- take care of the most common case where the FBX SDK is installed to the
@@ -40,24 +53,21 @@ end
 solution "fbx-conv"
 	configurations { "Debug", "Release" }
 	location (BUILD_DIR .. "/" .. _ACTION)
-	
-project "fbx-conv"
-	--- GENERAL STUFF FOR ALL PLATFORMS --------------------------------
+
+	--- GENERAL STUFF FOR ALL PROJECTS AND PLATFORMS -------------------
 	kind "ConsoleApp"
 	language "C++"
-	location (BUILD_DIR .. "/" .. _ACTION)
-	files {
-		"./src/**.c*",
-		"./src/**.h",
-	}
 	includedirs {
-		(FBX_SDK_ROOT .. "/include"),
+		fbxsdkpath("/include"),
 		"./libs/libpng/include",
 		"./libs/zlib/include",
 	}
 	defines {
 		"FBXSDK_NEW_API",
 	}
+	if not FBX_SDK_ROOT then
+		defines { "FBXCONV_NO_FBXSDK" }
+	end
 	--- debugdir "."
 
 	configuration "Debug"
@@ -84,24 +94,24 @@ project "fbx-conv"
 			"_CRT_NONSTDC_NO_WARNINGS"
 		}
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/vs2010/x86"),
+			fbxsdkpath("/lib/vs2010/x86"),
 			"./libs/libpng/lib/windows/x86",
 			"./libs/zlib/lib/windows/x86",
 		}
 		links {
 			"libpng14",
 			"zlib",
-			"libfbxsdk-md",
+			fbxsdk("libfbxsdk-md"),
 		}
 		
 	configuration { "vs*", "Debug" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/vs2010/x86/debug"),
+			fbxsdkpath("/lib/vs2010/x86/debug"),
 		}
 		
 	configuration { "vs*", "Release" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/vs2010/x86/release"),
+			fbxsdkpath("/lib/vs2010/x86/release"),
 		}
 
 	--- LINUX ----------------------------------------------------------
@@ -118,18 +128,18 @@ project "fbx-conv"
 			"png",
 			"z",
 			"pthread",
-			"fbxsdk",
+			fbxsdk("fbxsdk"),
 			"dl",
 		}
 
 	configuration { "linux", "Debug" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/gcc4/x64/debug"),
+			fbxsdkpath("/lib/gcc4/x64/debug"),
 		}
 		
 	configuration { "linux", "Release" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/gcc4/x64/release"),
+			fbxsdkpath("/lib/gcc4/x64/release"),
 		}
 
 	--- MAC ------------------------------------------------------------
@@ -137,7 +147,7 @@ project "fbx-conv"
 		kind "ConsoleApp"
 		buildoptions { "-Wall" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/gcc4/ub"),
+			fbxsdkpath("/lib/gcc4/ub"),
 			"./libs/libpng/lib/macosx",
 			"./libs/zlib/lib/macosx",
 		}
@@ -145,15 +155,44 @@ project "fbx-conv"
 			"png",
 			"z",
 			"CoreFoundation.framework",
-			"fbxsdk",
+			fbxsdk("fbxsdk"),
 		}
 
 	configuration { "macosx", "Debug" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/gcc4/ub/debug"),
+			fbxsdkpath("/lib/gcc4/ub/debug"),
 		}
 		
 	configuration { "macosx", "Release" }
 		libdirs {
-			(FBX_SDK_ROOT .. "/lib/gcc4/ub/release"),
+			fbxsdkpath("/lib/gcc4/ub/release"),
 		}
+
+project "fbx-conv"
+	location (BUILD_DIR .. "/" .. _ACTION)
+	files {
+		"./src/**.c*",
+		"./src/**.h",
+	}
+
+-- The benchmarks convert FBX files and call the FbxConverter directly, so they need the FBX SDK
+if FBX_SDK_ROOT then
+	-- Microbenchmarks of the hot kernels, using synthetic data (run with -t <seconds> and an optional name filter)
+	project "fbx-conv-bench"
+		location (BUILD_DIR .. "/" .. _ACTION)
+		files {
+			"./bench/Benchmark.h",
+			"./bench/kernels.cpp",
+			"./src/modeldata/Serialization.cpp",
+		}
+
+	-- End-to-end benchmark of the conversion of the bundled samples, see bench/samples.cpp for the options
+	project "fbx-conv-bench-samples"
+		location (BUILD_DIR .. "/" .. _ACTION)
+		files {
+			"./bench/Benchmark.h",
+			"./bench/JSONReader.h",
+			"./bench/samples.cpp",
+			"./src/modeldata/Serialization.cpp",
+		}
+end
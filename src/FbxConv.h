@@ -41,15 +41,27 @@
 #include "FbxConvCommand.h"
 #include "json/JSONWriter.h"
 #include "json/UBJSONWriter.h"
+#include "modeldata/G3DMWriter.h"
+#ifndef FBXCONV_NO_FBXSDK
 #include "readers/FbxConverter.h"
+#endif
+#include "readers/ObjReader.h"
+#include "image/TextureAtlas.h"
+#include "image/TextureProcessor.h"
+#include "log/jsonlog.h"
+#include "ModelStreamWriter.h"
 
 namespace fbxconv {
 
-void simpleTextureCallback(std::map<std::string, readers::TextureFileInfo> &textures) {
+void simpleTextureCallback(std::map<std::string, readers::TextureFileInfo> &textures, const Settings * const &settings, fbxconv::log::Log * const &log) {
 	for (std::map<std::string, readers::TextureFileInfo>::iterator it = textures.begin(); it != textures.end(); ++it) {
 		//printf("Texture name: %s\nbounds: %01.2f, %01.2f, %01.2f, %01.2f\ncount: %d\n", it->first.c_str(), it->second.bounds[0], it->second.bounds[1], it->second.bounds[2], it->second.bounds[3], it->second.nodeCount);
 		it->second.path = it->first.substr(it->first.find_last_of("/\\")+1);
 	}
+	if (settings->atlasSize > 0)
+		image::TextureAtlas(log, settings->atlasSize).build(textures, settings->inFile, settings->outFile, settings->flipV);
+	if (settings->maxTextureSize > 0 || settings->mipmaps || settings->premultiplyAlpha)
+		image::TextureProcessor(log, settings->maxTextureSize, settings->mipmaps, settings->premultiplyAlpha, settings->threadCount).process(textures, settings->inFile, settings->outFile);
 }
 
 class FbxConv {
@@ -82,10 +94,11 @@ class FbxConv {
 				log->filter &= ~log::Log::LOG_VERBOSE;
 
 
+			log->flush();
 			if (command.error != log::iNoError)
 				command.printCommand();
 			else if (!command.help)
-				return execute(&settings);
+				return settings.logFile.empty() ? execute(&settings) : executeWithJSONLog(&settings);
 
 			command.printHelp();
 			return false;
@@ -94,7 +107,9 @@ class FbxConv {
 		bool execute(Settings * const &settings) {
 			bool result = false;
 			modeldata::Model *model = new modeldata::Model();
-			if (load(settings, model)) {
+			if (settings->streaming)
+				result = stream(settings, model);
+			else if (load(settings, model)) {
 				if (settings->verbose)
 					info(model);
 				if (save(settings, model))
@@ -104,6 +119,26 @@ class FbxConv {
 			return result;
 		}
 
+		/** Execute while also logging to the JSON log file of the settings */
+		bool executeWithJSONLog(Settings * const &settings) {
+			FILE *file = fopen(settings->logFile.c_str(), "w");
+			if (!file) {
+				log->error(log::eCommandLineInvalidLogFile, settings->logFile.c_str());
+				return false;
+			}
+			log::Log * const console = log;
+			bool result;
+			{
+				log::JSONLog jsonLog(new log::DefaultMessages(), file, console, (console->filter | log::Log::LOG_VERBOSE) & ~log::Log::LOG_PROGRESS);
+				jsonLog.inputFile = settings->inFile;
+				log = &jsonLog;
+				result = execute(settings);
+				log = console;
+			}
+			fclose(file);
+			return result;
+		}
+
 		readers::Reader *createReader(const Settings * const &settings) {
 			return createReader(settings->inType);
 		}
@@ -111,28 +146,37 @@ class FbxConv {
 		readers::Reader *createReader(const int &type) {
 			switch(type) {
 			case FILETYPE_FBX: 
+#ifndef FBXCONV_NO_FBXSDK
 				return new readers::FbxConverter(log, simpleTextureCallback);
+#else
+				log->error(log::eSourceLoadFbxNoSdk);
+				return 0;
+#endif
+			case FILETYPE_OBJ:
+				return new readers::ObjReader(log, simpleTextureCallback);
 			case FILETYPE_G3DB:
 			case FILETYPE_G3DJ:
+			case FILETYPE_G3DM:
 			default:
 				log->error(log::eSourceLoadFiletypeUnknown);
 				return 0;
 			}
 		}
 
-		bool load(Settings * const &settings, modeldata::Model *model) {
+		bool load(Settings * const &settings, modeldata::Model *model, readers::MeshListener * const &meshListener = 0) {
 			log->status(log::sSourceLoad);
 
 			readers::Reader *reader = createReader(settings);
 			if (!reader)
 				return false;
+			reader->meshListener = meshListener;
 
 			bool result = reader->load(settings);
 			if (!result)
-				log->error(log::eSourceLoadGeneral);
+				log->error(log::eSourceLoadGeneral, settings->inFile.c_str());
 			else {
-				result = reader->convert(model);
 				log->status(log::sSourceConvert);
+				result = reader->convert(model);
 			}
 
 			log->status(log::sSourceClose);
@@ -141,31 +185,68 @@ class FbxConv {
 			return result;
 		}
 
-		bool save(Settings * const &settings, modeldata::Model *model) {
-			bool result = false;
+		/** Write each mesh as soon as it is converted and release its data, instead of writing the model after the conversion */
+		bool stream(Settings * const &settings, modeldata::Model *model) {
 			std::ofstream myfile;
 			myfile.open (settings->outFile.c_str(), std::ios::binary);
-
-			json::BaseJSONWriter *jsonWriter = 0;
+			bool result;
 			switch(settings->outType) {
-			case FILETYPE_G3DB: 
+			case FILETYPE_G3DB: {
 				log->status(log::sExportToG3DB, settings->outFile.c_str());
-				jsonWriter = new json::UBJSONWriter(myfile);
+				json::UBJSONWriter writer(myfile);
+				result = stream(settings, model, writer, myfile);
 				break;
-			case FILETYPE_G3DJ: 
+			}
+			case FILETYPE_G3DJ: {
 				log->status(log::sExportToG3DJ, settings->outFile.c_str());
-				jsonWriter = new json::JSONWriter(myfile);
+				json::JSONWriter writer(myfile);
+				result = stream(settings, model, writer, myfile);
 				break;
-			default: 
+			}
+			default:
 				log->error(log::eExportFiletypeUnknown);
-				break;
+				myfile.close();
+				return false;
 			}
 
-			if (jsonWriter) {
-				(*jsonWriter) << model;
-				delete jsonWriter;
+			log->status(log::sExportClose);
+			myfile.close();
+			return result;
+		}
+
+		/** Convert the model while writing it with the writer, which is passed as its own type so the values are written statically */
+		template<class W> bool stream(Settings * const &settings, modeldata::Model *model, W &writer, std::ostream &stream) {
+			ModelStreamWriter<W> streamWriter(writer, stream);
+			streamWriter.begin(model);
+			const bool result = load(settings, model, &streamWriter);
+			streamWriter.end(model);
+			return result;
+		}
+
+		bool save(Settings * const &settings, modeldata::Model *model) {
+			bool result = false;
+			std::ofstream myfile;
+			myfile.open (settings->outFile.c_str(), std::ios::binary);
+
+			if (settings->outType == FILETYPE_G3DM) {
+				log->status(log::sExportToG3DM, settings->outFile.c_str());
+				modeldata::G3DMWriter(myfile).write(model);
+				result = true;
+			}
+			else if (settings->outType == FILETYPE_G3DB) {
+				log->status(log::sExportToG3DB, settings->outFile.c_str());
+				json::UBJSONWriter writer(myfile);
+				writer << model;
 				result = true;
 			}
+			else if (settings->outType == FILETYPE_G3DJ) {
+				log->status(log::sExportToG3DJ, settings->outFile.c_str());
+				json::JSONWriter writer(myfile);
+				writer << model;
+				result = true;
+			}
+			else
+				log->error(log::eExportFiletypeUnknown);
 
 			log->status(log::sExportClose);
 			myfile.close();
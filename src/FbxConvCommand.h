@@ -21,8 +21,16 @@
 
 #include "Settings.h"
 #include <string>
+#include <algorithm>
+#include <functional>
 #include "log/log.h"
 
+// The FBX SDK headers declare stricmp on all platforms, without them it's only available on Windows
+#if defined(FBXCONV_NO_FBXSDK) && !defined(_MSC_VER)
+#include <strings.h>
+#define stricmp strcasecmp
+#endif
+
 namespace fbxconv {
 
 struct FbxConvCommand {
@@ -44,6 +52,26 @@ struct FbxConvCommand {
 		settings->maxVertexBonesCount = 4;
 		settings->maxVertexCount = (1<<15)-1;
 		settings->maxIndexCount = (1<<15)-1;
+		settings->weldVertices = false;
+		settings->weldPosition = 0.f;
+		settings->weldNormalAngle = 1.f;
+		settings->weldUV = 0.0001f;
+		settings->weldColor = 0.002f;
+		settings->staticBatching = false;
+		settings->atlasSize = 0;
+		settings->maxTextureSize = 0;
+		settings->mipmaps = false;
+		settings->premultiplyAlpha = false;
+		settings->threadCount = 0;
+		settings->mergeMaterials = false;
+		settings->streaming = false;
+		settings->keyframeTracks = false;
+		settings->quantizeAnimations = false;
+		settings->animationTolerance = 0.000001f;
+		settings->unifiedTimeline = false;
+		settings->skeleton = false;
+		settings->blendShapes = false;
+		settings->triangleStrips = false;
 		settings->outType = FILETYPE_AUTO;
 		settings->inType = FILETYPE_AUTO;
 
@@ -59,6 +87,18 @@ struct FbxConvCommand {
 					settings->verbose = true;
 				else if (arg[1] == 'p')
 					settings->packColors = true;
+				else if (arg[1] == 's')
+					settings->staticBatching = true;
+				else if (arg[1] == 'g')
+					settings->mipmaps = true;
+				else if (arg[1] == 'r')
+					settings->premultiplyAlpha = true;
+				else if (arg[1] == 'u')
+					settings->mergeMaterials = true;
+				else if (arg[1] == 'z')
+					settings->streaming = true;
+				else if (arg[1] == 'k')
+					settings->keyframeTracks = true;
 				else if ((arg[1] == 'i') && (i + 1 < argc))
 					settings->inType = parseType(argv[++i]);
 				else if ((arg[1] == 'o') && (i + 1 < argc))
@@ -69,6 +109,32 @@ struct FbxConvCommand {
 					settings->maxVertexBonesCount = atoi(argv[++i]);
 				else if ((arg[1] == 'm') && (i + 1 < argc))
 					settings->maxVertexCount = settings->maxIndexCount = atoi(argv[++i]);
+				else if ((arg[1] == 'e') && (i + 1 < argc))
+					parseWeldTolerance(argv[++i]);
+				else if ((arg[1] == 'd') && (i + 1 < argc))
+					parseLodRatios(argv[++i]);
+				else if ((arg[1] == 'a') && (i + 1 < argc))
+					settings->atlasSize = atoi(argv[++i]);
+				else if ((arg[1] == 't') && (i + 1 < argc))
+					settings->maxTextureSize = atoi(argv[++i]);
+				else if ((arg[1] == 'j') && (i + 1 < argc))
+					settings->threadCount = atoi(argv[++i]);
+				else if ((arg[1] == 'l') && (i + 1 < argc))
+					settings->logFile = argv[++i];
+				else if (arg[1] == 'y')
+					settings->unifiedTimeline = true;
+				else if (arg[1] == 'n')
+					settings->skeleton = true;
+				else if (arg[1] == 'x')
+					settings->blendShapes = true;
+				else if (arg[1] == 'S')
+					settings->triangleStrips = true;
+				else if ((arg[1] == 'c') && (i + 1 < argc))
+					settings->clipFile = argv[++i];
+				else if ((arg[1] == 'q') && (i + 1 < argc)) {
+					settings->quantizeAnimations = true;
+					settings->animationTolerance = (float)atof(argv[++i]);
+				}
 				else
 					log->error(error = log::eCommandLineUnknownOption, arg);
 			}
@@ -108,12 +174,36 @@ struct FbxConvCommand {
 		printf("-m <size>: The maximum amount of vertices or indices a mesh may contain (default: 32k)\n");
 		printf("-b <size>: The maximum amount of bones a nodepart can contain (default: 12)\n");
 		printf("-w <size>: The maximum amount of bone weights per vertex (default: 4)\n");
+		printf("-e <pos>[,<angle>[,<uv>[,<color>]]]: Weld vertices within the tolerance of the\n");
+		printf("           position, normal angle in degrees (default: 1), texture coordinate\n");
+		printf("           (default: 0.0001) and color (default: 0.002)\n");
+		printf("-d <ratio>[,<ratio>...]: Generate levels of detail for each meshpart with the\n");
+		printf("           specified ratios (between 0 and 1) of the original triangle count\n");
+		printf("-s       : Bake the transform of static nodes and merge their parts per material.\n");
+		printf("-a <size>: Pack the used area of the PNG textures into atlas pages of at most\n");
+		printf("           <size> by <size> pixels (power of two, at least 64)\n");
+		printf("-t <size>: Scale the PNG textures down to at most <size> by <size> pixels\n");
+		printf("-g       : Generate the mipmaps of the PNG textures (written as KTX)\n");
+		printf("-r       : Premultiply the alpha of the PNG textures\n");
+		printf("-u       : Merge materials with equal values and textures\n");
+		printf("-z       : Write each mesh as soon as it is converted, to reduce the memory usage\n");
+		printf("-k       : Write the keyframes of each node as arrays of keytimes and values\n");
+		printf("-q <tol> : Reduce and quantize the keyframe arrays (implies -k), the error of each\n");
+		printf("           value stays within <tol> (e.g. 0.0001)\n");
+		printf("-y       : Sample all nodes of an animation at the same keytimes (implies -k)\n");
+		printf("-n       : Write the bones once in a skeleton with their inverse bind matrix\n");
+		printf("-x       : Convert the blend shapes of the meshes and the animation of their weights\n");
+		printf("-S       : Write the meshparts as triangle strips when that needs less indices\n");
+		printf("-c <file>: Split the animations into the clips listed in <file>, one per line:\n");
+		printf("           <name> <start> <end> [<take>], times in seconds\n");
+		printf("-j <num> : The number of threads to use (default: number of processors)\n");
+		printf("-l <file>: Also write the log to <file>, one JSON object per line\n");
 		printf("-v       : Verbose: print additional progress information\n");
 		printf("\n");
 		printf("<input>  : The filename of the file to convert.\n");
 		printf("<output> : The filename of the converted file.\n");
 		printf("\n");
-		printf("<type>   : FBX, G3DJ (json) or G3DB (binary).\n");
+		printf("<type>   : FBX, OBJ (input only), G3DJ (json), G3DB (binary) or G3DM (memory mappable).\n");
 	}
 private:
 	void validate() {
@@ -125,7 +215,7 @@ private:
 		if (inType == FILETYPE_AUTO)
 			inType = guessType(inFile, FILETYPE_IN_DEFAULT);
 #else
-		settings->inType = FILETYPE_IN_DEFAULT;
+		settings->inType = guessType(settings->inFile, FILETYPE_IN_DEFAULT) == FILETYPE_OBJ ? FILETYPE_OBJ : FILETYPE_IN_DEFAULT;
 #endif
 		if (settings->outFile.empty())
 			setExtension(
@@ -145,15 +235,107 @@ private:
 			log->error(error = log::eCommandLineInvalidVertexCount);
 			return;
 		}
+		if (settings->weldVertices && (settings->weldPosition < 0.f || settings->weldNormalAngle < 0.f || settings->weldNormalAngle > 180.f ||
+				settings->weldUV < 0.f || settings->weldColor < 0.f)) {
+			log->error(error = log::eCommandLineInvalidWeldTolerance);
+			return;
+		}
+		for (std::vector<float>::const_iterator itr = settings->lodRatios.begin(); itr != settings->lodRatios.end(); ++itr) {
+			if ((*itr) <= 0.f || (*itr) >= 1.f) {
+				log->error(error = log::eCommandLineInvalidLodRatio);
+				return;
+			}
+		}
+		std::sort(settings->lodRatios.begin(), settings->lodRatios.end(), std::greater<float>());
+		if (settings->atlasSize < 0 || (settings->atlasSize > 0 && (settings->atlasSize < 64 || (settings->atlasSize & (settings->atlasSize - 1)) != 0))) {
+			log->error(error = log::eCommandLineInvalidAtlasSize);
+			return;
+		}
+		if (settings->maxTextureSize < 0) {
+			log->error(error = log::eCommandLineInvalidTextureSize);
+			return;
+		}
+		if (settings->threadCount < 0) {
+			log->error(error = log::eCommandLineInvalidThreadCount);
+			return;
+		}
+		if (settings->quantizeAnimations && !(settings->animationTolerance > 0.f)) {
+			log->error(error = log::eCommandLineInvalidAnimationTolerance);
+			return;
+		}
+		if (!settings->clipFile.empty() && !parseClipFile(settings->clipFile.c_str())) {
+			log->error(error = log::eCommandLineInvalidClipFile, settings->clipFile.c_str());
+			return;
+		}
+		if (settings->quantizeAnimations || settings->unifiedTimeline)
+			settings->keyframeTracks = true;
+		if (settings->streaming && settings->outType != FILETYPE_G3DB && settings->outType != FILETYPE_G3DJ) {
+			log->error(error = log::eCommandLineStreamingFiletype);
+			return;
+		}
+		// The G3DM format has no sections for the blend shapes and their animation
+		if (settings->blendShapes && settings->outType == FILETYPE_G3DM) {
+			log->error(error = log::eCommandLineBlendShapesFiletype);
+			return;
+		}
+	}
+
+	void parseWeldTolerance(const char* arg) {
+		settings->weldVertices = true;
+		if (sscanf(arg, "%f,%f,%f,%f", &settings->weldPosition, &settings->weldNormalAngle, &settings->weldUV, &settings->weldColor) < 1)
+			settings->weldPosition = -1.f;
+	}
+
+	void parseLodRatios(const char* arg) {
+		settings->lodRatios.clear();
+		for (const char *s = arg; s != 0; s = strchr(s, ',')) {
+			if (*s == ',')
+				s++;
+			settings->lodRatios.push_back((float)atof(s));
+		}
+	}
+
+	/** Read the clips, ignoring empty lines and comments (starting with #), returns false if the file can't be read or a
+	 * line isn't a valid clip */
+	bool parseClipFile(const char* filename) {
+		FILE *file = fopen(filename, "r");
+		if (!file)
+			return false;
+		settings->clips.clear();
+		bool result = true;
+		char line[1024], name[256];
+		while (result && fgets(line, sizeof(line), file)) {
+			AnimationClip clip;
+			int length = 0;
+			const int n = sscanf(line, "%255s %f %f%n", name, &clip.start, &clip.stop, &length);
+			if (n <= 0 || name[0] == '#')
+				continue;
+			if (n < 3 || clip.stop <= clip.start)
+				result = false;
+			clip.name = name;
+			// The take is the rest of the line, take names (e.g. "Take 001") may contain spaces
+			if (n == 3) {
+				clip.take = line + length;
+				const std::string::size_type first = clip.take.find_first_not_of(" \t\r\n");
+				clip.take = first == std::string::npos ? std::string() : clip.take.substr(first, clip.take.find_last_not_of(" \t\r\n") - first + 1);
+			}
+			settings->clips.push_back(clip);
+		}
+		fclose(file);
+		return result;
 	}
 
 	int parseType(const char* arg, const int &def = -1) {
 		if (stricmp(arg, "fbx")==0)
 			return FILETYPE_FBX;
+		else if (stricmp(arg, "obj")==0)
+			return FILETYPE_OBJ;
 		else if (stricmp(arg, "g3db")==0)
 			return FILETYPE_G3DB;
 		else if (stricmp(arg, "g3dj")==0)
 			return FILETYPE_G3DJ;
+		else if (stricmp(arg, "g3dm")==0)
+			return FILETYPE_G3DM;
 		if (def < 0)
 			log->error(error = log::eCommandLineUnknownFiletype, arg);
 		return def;
@@ -178,8 +360,10 @@ private:
 	void setExtension(std::string &fn, const int &type) const {
 		switch(type) {
 		case FILETYPE_FBX:	return setExtension(fn, "fbx");
+		case FILETYPE_OBJ:	return setExtension(fn, "obj");
 		case FILETYPE_G3DB:	return setExtension(fn, "g3db");
 		case FILETYPE_G3DJ:	return setExtension(fn, "g3dj");
+		case FILETYPE_G3DM:	return setExtension(fn, "g3dm");
 		default:			return setExtension(fn, "");
 		}
 	}
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELSTREAMWRITER_H
+#define FBXCONV_MODELSTREAMWRITER_H
+
+#include <ostream>
+#include <vector>
+#include "modeldata/Model.h"
+#include "readers/Reader.h"
+#include "json/BaseJSONWriter.h"
+
+namespace fbxconv {
+	/** Writes the model while it is being converted: each mesh is written (and its data released) as soon as the reader
+	 * completed it, the rest of the model is written by end(). The output has the same layout as when writing the whole
+	 * model at once, followed by a "meshIndex" array with the byte offset and length of each mesh within the file. In the
+	 * JSON format the range of a mesh may start with the separator and white space preceding it. W is the type of the writer,
+	 * which is used directly (not through BaseJSONWriter) so writing the model doesn't need a virtual call per value. */
+	template<class W> class ModelStreamWriter : public readers::MeshListener {
+	public:
+		ModelStreamWriter(W &writer, std::ostream &stream) : writer(writer), stream(stream) {}
+
+		/** Write the start of the model, must be called before the first mesh is completed */
+		void begin(const modeldata::Model * const &model) {
+			writer.obj(7);
+			writer << "version" = model->version;
+			writer << "id" = model->id;
+			writer.val("meshes").is().arr();
+		}
+
+		virtual void meshCompleted(modeldata::Mesh * const &mesh) {
+			const std::streamoff offset = stream.tellp();
+			writer << mesh;
+			index.push_back(std::make_pair(offset, stream.tellp() - offset));
+			mesh->releaseData();
+		}
+
+		/** Write the remainder of the model, must also be called if the conversion failed to complete the output */
+		void end(const modeldata::Model * const &model) {
+			writer.end();
+			writer << "materials" = model->materials;
+			if (!model->skeleton.empty())
+				writer << "skeleton" = model->skeleton;
+			writer << "nodes" = model->nodes;
+			writer << "animations" = model->animations;
+			// Doubles, because offsets might not fit in 32 bits
+			writer.val("meshIndex").is().arr(index.size(), 2);
+			for (std::vector<std::pair<std::streamoff, std::streamoff> >::const_iterator itr = index.begin(); itr != index.end(); ++itr)
+				writer.arr(2, 2) << (double)itr->first << (double)itr->second << json::end;
+			writer.end();
+			writer.end();
+		}
+
+	private:
+		W &writer;
+		std::ostream &stream;
+		std::vector<std::pair<std::streamoff, std::streamoff> > index;
+	};
+}
+
+#endif //FBXCONV_MODELSTREAMWRITER_H
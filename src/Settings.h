@@ -21,16 +21,28 @@
 #define SETTINGS_H
 
 #include <string>
+#include <vector>
 
 namespace fbxconv {
 
 #define FILETYPE_AUTO			0x00
 #define FILETYPE_FBX			0x10
+#define FILETYPE_OBJ			0x11
 #define FILETYPE_G3DB			0x20
 #define FILETYPE_G3DJ			0x21
+#define FILETYPE_G3DM			0x22
 #define FILETYPE_OUT_DEFAULT	FILETYPE_G3DB
 #define FILETYPE_IN_DEFAULT		FILETYPE_FBX
 
+/** A named time range of an animation stack (take), which is converted as a separate animation */
+struct AnimationClip {
+	std::string name;
+	/** The name of the animation stack the clip is taken from, or empty for every animation stack */
+	std::string take;
+	/** The start and end time (in seconds) of the clip */
+	float start, stop;
+};
+
 struct Settings {
 	std::string inFile;
 	int inType;
@@ -51,6 +63,54 @@ struct Settings {
 	int maxVertexCount;
 	/** The maximum allowed amount of indices in one mesh, only used when deciding to merge meshes. */
 	int maxIndexCount;
+	/** Whether to weld vertices that are within the tolerances below, instead of only merging identical vertices. */
+	bool weldVertices;
+	/** The maximum distance between two welded vertex positions. */
+	float weldPosition;
+	/** The maximum angle (in degrees) between two welded normals, tangents or binormals. */
+	float weldNormalAngle;
+	/** The maximum difference between two welded texture coordinates. */
+	float weldUV;
+	/** The maximum difference between two welded vertex colors (0 to 1). */
+	float weldColor;
+	/** The triangle ratios (between 0 and 1, from high to low) of the levels of detail to generate for each meshpart. */
+	std::vector<float> lodRatios;
+	/** Whether to bake the transform of nodes without animation or skinning into the vertices and merge their parts per material. */
+	bool staticBatching;
+	/** The maximum width and height of the texture atlas pages to pack the used area of the textures into, or 0 to disable. */
+	int atlasSize;
+	/** The maximum width and height of the textures, larger textures are scaled down, or 0 to keep their size. */
+	int maxTextureSize;
+	/** Whether to generate the mipmaps of the textures (written as KTX). */
+	bool mipmaps;
+	/** Whether to multiply the color of the textures by their alpha. */
+	bool premultiplyAlpha;
+	/** The number of threads to use, or 0 to use the number of hardware threads. */
+	int threadCount;
+	/** Whether to merge the materials with equal values and textures. */
+	bool mergeMaterials;
+	/** The file to write the log to as JSON (one object per line), or empty to only log to the console. */
+	std::string logFile;
+	/** Whether to write each mesh as soon as it is converted and release its data, to reduce the memory usage. */
+	bool streaming;
+	/** Whether to write the keyframes of each node as tracks (arrays of keytimes and values), instead of an object per keyframe. */
+	bool keyframeTracks;
+	/** Whether to quantize the keyframe tracks to 16 bit values, where the error stays within the animation tolerance. */
+	bool quantizeAnimations;
+	/** The maximum error of the keyframes removed by the reduction and of the quantized keyframe values. */
+	float animationTolerance;
+	/** Whether to sample all nodes of an animation at the same keytimes, which are written once for the animation. */
+	bool unifiedTimeline;
+	/** The file listing the clips to split the animation stacks into, or empty to convert each stack as one animation. */
+	std::string clipFile;
+	/** The clips read from the clip file. */
+	std::vector<AnimationClip> clips;
+	/** Whether to list the bones once in a skeleton with their inverse bind matrix, referenced by index from the nodeparts. */
+	bool skeleton;
+	/** Whether to convert the blend shapes of the meshes (the changed vertices) and the animation of their weights. */
+	bool blendShapes;
+	/** Whether to write the meshparts as triangle strips, joined by degenerate triangles, when that needs less indices. */
+	bool triangleStrips;
 };
 
 }
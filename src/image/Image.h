@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_IMAGE_IMAGE_H
+#define FBXCONV_IMAGE_IMAGE_H
+
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <string.h>
+#include <png.h>
+
+namespace fbxconv {
+namespace image {
+	/** An image with 8 bit red, green, blue and alpha channels, stored row by row from the top left. */
+	struct Image {
+		unsigned int width;
+		unsigned int height;
+		std::vector<unsigned char> pixels;
+
+		Image() : width(0), height(0) {}
+
+		Image(const unsigned int &width, const unsigned int &height) : width(0), height(0) {
+			resize(width, height);
+		}
+
+		/** Change the size of the image, the content of the image is undefined afterwards. */
+		void resize(const unsigned int &width, const unsigned int &height) {
+			this->width = width;
+			this->height = height;
+			pixels.assign(width * height * 4, 0);
+		}
+
+		inline unsigned char *pixel(const unsigned int &x, const unsigned int &y) {
+			return &pixels[(y * width + x) * 4];
+		}
+
+		inline const unsigned char *pixel(const unsigned int &x, const unsigned int &y) const {
+			return &pixels[(y * width + x) * 4];
+		}
+
+		/** Copy the w by h area at (srcX, srcY) of the source image to (x, y) of this image. */
+		void draw(const Image &source, const unsigned int &srcX, const unsigned int &srcY, const unsigned int &w, const unsigned int &h, const unsigned int &x, const unsigned int &y) {
+			for (unsigned int row = 0; row < h; row++)
+				memcpy(pixel(x, y + row), source.pixel(srcX, srcY + row), w * 4);
+		}
+
+		/** Resample the image to the specified size by averaging the pixels each target pixel covers (box filter). */
+		void scale(Image &out, const unsigned int &w, const unsigned int &h) const {
+			out.resize(w, h);
+			for (unsigned int y = 0; y < h; y++) {
+				const unsigned int y1 = (unsigned int)((unsigned long long)y * height / h);
+				unsigned int y2 = (unsigned int)((unsigned long long)(y + 1) * height / h);
+				if (y2 <= y1)
+					y2 = y1 + 1;
+				for (unsigned int x = 0; x < w; x++) {
+					const unsigned int x1 = (unsigned int)((unsigned long long)x * width / w);
+					unsigned int x2 = (unsigned int)((unsigned long long)(x + 1) * width / w);
+					if (x2 <= x1)
+						x2 = x1 + 1;
+					unsigned int sum[4] = {0, 0, 0, 0};
+					for (unsigned int sy = y1; sy < y2; sy++) {
+						const unsigned char *p = pixel(x1, sy);
+						for (unsigned int sx = x1; sx < x2; sx++, p += 4)
+							for (int c = 0; c < 4; c++)
+								sum[c] += p[c];
+					}
+					const unsigned int n = (x2 - x1) * (y2 - y1);
+					unsigned char *d = out.pixel(x, y);
+					for (int c = 0; c < 4; c++)
+						d[c] = (unsigned char)((sum[c] + n / 2) / n);
+				}
+			}
+		}
+
+		/** Create the next mipmap level, which is half the size (at least one pixel) of this image. */
+		void halve(Image &out) const {
+			scale(out, width > 1 ? width / 2 : 1, height > 1 ? height / 2 : 1);
+		}
+
+		/** Multiply the color channels by the alpha channel */
+		void premultiplyAlpha() {
+			for (std::vector<unsigned char>::iterator itr = pixels.begin(); itr != pixels.end(); itr += 4) {
+				const unsigned int a = itr[3];
+				for (int c = 0; c < 3; c++)
+					itr[c] = (unsigned char)((itr[c] * a + 127) / 255);
+			}
+		}
+
+		/** Load a PNG file, any color type is converted to 8 bit RGBA. Returns false if the file couldn't be read. */
+		bool load(const char * const &filename) {
+			FILE *file = fopen(filename, "rb");
+			if (!file)
+				return false;
+			png_byte header[8];
+			if (fread(header, 1, 8, file) != 8 || png_sig_cmp(header, 0, 8)) {
+				fclose(file);
+				return false;
+			}
+			png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+			png_infop info = png ? png_create_info_struct(png) : 0;
+			std::vector<png_bytep> rows;
+			if (!info || setjmp(png_jmpbuf(png))) {
+				png_destroy_read_struct(&png, info ? &info : 0, 0);
+				fclose(file);
+				width = height = 0;
+				pixels.clear();
+				return false;
+			}
+			png_init_io(png, file);
+			png_set_sig_bytes(png, 8);
+			png_read_info(png, info);
+			const png_byte colorType = png_get_color_type(png, info);
+			png_set_expand(png);
+			png_set_strip_16(png);
+			if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+				png_set_gray_to_rgb(png);
+			if (!(colorType & PNG_COLOR_MASK_ALPHA) && !png_get_valid(png, info, PNG_INFO_tRNS))
+				png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+			png_set_interlace_handling(png);
+			png_read_update_info(png, info);
+			resize(png_get_image_width(png, info), png_get_image_height(png, info));
+			rows.resize(height);
+			for (unsigned int y = 0; y < height; y++)
+				rows[y] = pixel(0, y);
+			png_read_image(png, &rows[0]);
+			png_read_end(png, 0);
+			png_destroy_read_struct(&png, &info, 0);
+			fclose(file);
+			return true;
+		}
+
+		/** Save the image as an RGBA PNG file. Returns false if the file couldn't be written. */
+		bool save(const char * const &filename) const {
+			if (width == 0 || height == 0)
+				return false;
+			FILE *file = fopen(filename, "wb");
+			if (!file)
+				return false;
+			png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+			png_infop info = png ? png_create_info_struct(png) : 0;
+			std::vector<png_bytep> rows(height);
+			if (!info || setjmp(png_jmpbuf(png))) {
+				png_destroy_write_struct(&png, info ? &info : 0);
+				fclose(file);
+				return false;
+			}
+			png_init_io(png, file);
+			png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+			png_write_info(png, info);
+			for (unsigned int y = 0; y < height; y++)
+				rows[y] = (png_bytep)pixel(0, y);
+			png_write_image(png, &rows[0]);
+			png_write_end(png, 0);
+			png_destroy_write_struct(&png, &info);
+			fclose(file);
+			return true;
+		}
+
+		/** Whether the filename has the PNG extension */
+		static bool isPNG(const std::string &filename) {
+			const std::string::size_type dot = filename.find_last_of('.');
+			if (dot == std::string::npos || filename.length() - dot != 4)
+				return false;
+			const char *ext = filename.c_str() + dot + 1;
+			return (ext[0] == 'p' || ext[0] == 'P') && (ext[1] == 'n' || ext[1] == 'N') && (ext[2] == 'g' || ext[2] == 'G');
+		}
+	};
+}
+}
+
+#endif //FBXCONV_IMAGE_IMAGE_H
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_IMAGE_KTX_H
+#define FBXCONV_IMAGE_KTX_H
+
+#include <vector>
+#include <stdio.h>
+#include "Image.h"
+
+namespace fbxconv {
+namespace image {
+	/** Writes uncompressed RGBA images, including their mipmap levels, to the Khronos KTX container format. */
+	struct KTX {
+		static const unsigned int TYPE_UNSIGNED_BYTE = 0x1401;
+		static const unsigned int FORMAT_RGBA = 0x1908;
+
+		/** Save the levels, the first being the base image and each next one a mipmap level of the previous. */
+		static bool save(const char * const &filename, const std::vector<Image> &levels) {
+			static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+			if (levels.empty())
+				return false;
+			FILE *file = fopen(filename, "wb");
+			if (!file)
+				return false;
+			bool result = fwrite(identifier, 1, 12, file) == 12;
+			const unsigned int header[13] = {
+				0x04030201,					// endianness
+				TYPE_UNSIGNED_BYTE, 1,		// glType, glTypeSize
+				FORMAT_RGBA, FORMAT_RGBA, FORMAT_RGBA,	// glFormat, glInternalFormat, glBaseInternalFormat
+				levels[0].width, levels[0].height, 0,	// pixelWidth, pixelHeight, pixelDepth
+				0, 1,						// numberOfArrayElements, numberOfFaces
+				(unsigned int)levels.size(),	// numberOfMipmapLevels
+				0							// bytesOfKeyValueData
+			};
+			result = result && writeInts(file, header, 13);
+			// Each RGBA row is a multiple of four bytes, so no row or mip padding is needed
+			for (std::vector<Image>::const_iterator itr = levels.begin(); result && itr != levels.end(); ++itr) {
+				const unsigned int size = (unsigned int)itr->pixels.size();
+				result = writeInts(file, &size, 1) && fwrite(&itr->pixels[0], 1, size, file) == size;
+			}
+			fclose(file);
+			return result;
+		}
+
+	private:
+		// KTX uses the endianness of the writer, which is specified in the header
+		static bool writeInts(FILE * const &file, const unsigned int * const &values, const size_t &count) {
+			return fwrite(values, sizeof(unsigned int), count, file) == count;
+		}
+	};
+}
+}
+
+#endif //FBXCONV_IMAGE_KTX_H
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_IMAGE_RECTPACKER_H
+#define FBXCONV_IMAGE_RECTPACKER_H
+
+#include <vector>
+#include <algorithm>
+
+namespace fbxconv {
+namespace image {
+	/** Packs rectangles into one or more square pages using shelves, the rectangles are placed from the highest to the lowest. */
+	class RectPacker {
+	public:
+		struct Rect {
+			unsigned int width, height;
+			/** The page and position the rectangle is packed to, set by pack() */
+			unsigned int page, x, y;
+			/** User defined index of the rectangle */
+			unsigned int index;
+			Rect(const unsigned int &width = 0, const unsigned int &height = 0, const unsigned int &index = 0)
+				: width(width), height(height), page(0), x(0), y(0), index(index) {}
+		};
+
+		/** The size of each page */
+		const unsigned int pageSize;
+		/** The used width and height of each page, set by pack() */
+		std::vector<std::pair<unsigned int, unsigned int> > pages;
+
+		RectPacker(const unsigned int &pageSize) : pageSize(pageSize) {}
+
+		/** Pack the rectangles, each rectangle must fit within a page. Returns the number of pages used. */
+		unsigned int pack(std::vector<Rect> &rects) {
+			std::sort(rects.begin(), rects.end(), compareHeight);
+			std::vector<Shelf> shelves;
+			pages.clear();
+			for (std::vector<Rect>::iterator itr = rects.begin(); itr != rects.end(); ++itr) {
+				Shelf *shelf = 0;
+				// Best fit: the lowest shelf with enough room left
+				for (std::vector<Shelf>::iterator it = shelves.begin(); it != shelves.end(); ++it)
+					if (it->height >= itr->height && pageSize - it->width >= itr->width && (shelf == 0 || it->height < shelf->height))
+						shelf = &(*it);
+				if (shelf == 0) {
+					unsigned int page = 0;
+					while (page < pages.size() && pageSize - pages[page].second < itr->height)
+						page++;
+					if (page == pages.size())
+						pages.push_back(std::make_pair(0u, 0u));
+					shelves.push_back(Shelf(page, pages[page].second, itr->height));
+					pages[page].second += itr->height;
+					shelf = &shelves.back();
+				}
+				itr->page = shelf->page;
+				itr->x = shelf->width;
+				itr->y = shelf->y;
+				shelf->width += itr->width;
+				if (shelf->width > pages[shelf->page].first)
+					pages[shelf->page].first = shelf->width;
+			}
+			return (unsigned int)pages.size();
+		}
+
+	private:
+		struct Shelf {
+			unsigned int page, y, width, height;
+			Shelf(const unsigned int &page, const unsigned int &y, const unsigned int &height) : page(page), y(y), width(0), height(height) {}
+		};
+
+		static bool compareHeight(const Rect &a, const Rect &b) {
+			return a.height > b.height || (a.height == b.height && a.width > b.width);
+		}
+	};
+}
+}
+
+#endif //FBXCONV_IMAGE_RECTPACKER_H
@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_IMAGE_TEXTUREATLAS_H
+#define FBXCONV_IMAGE_TEXTUREATLAS_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <math.h>
+#include "Image.h"
+#include "RectPacker.h"
+#include "../readers/TextureFileInfo.h"
+#include "../log/log.h"
+
+namespace fbxconv {
+namespace image {
+	/** Packs the used area of the PNG textures into one or more atlas pages and updates the uv translation and scale of the
+	 * material textures accordingly. Textures which are repeated (used outside the 0-1 uv range) or already have a uv
+	 * transformation are left as is. */
+	class TextureAtlas {
+	public:
+		/** The maximum width and height of a page */
+		const unsigned int pageSize;
+		/** The amount of pixels around each texture, filled with the edge of the texture to avoid bleeding */
+		const unsigned int padding;
+
+		TextureAtlas(fbxconv::log::Log * const &log, const unsigned int &pageSize, const unsigned int &padding = 2)
+			: pageSize(pageSize), padding(padding), log(log) {}
+
+		/** Create the atlas pages next to the output file, the path of each packed texture is set to the filename of its page.
+		 * The flipV argument specifies whether the v texture coordinate is flipped during conversion.
+		 * Returns the number of textures packed. */
+		unsigned int build(std::map<std::string, readers::TextureFileInfo> &textures, const std::string &inFile, const std::string &outFile, const bool &flipV) {
+			const std::string inDir = readers::TextureFileInfo::getDirectory(inFile);
+			std::vector<Entry> entries;
+			std::vector<RectPacker::Rect> rects;
+			for (std::map<std::string, readers::TextureFileInfo>::iterator itr = textures.begin(); itr != textures.end(); ++itr) {
+				if (!canPack(itr->first, itr->second))
+					continue;
+				const std::string filename = readers::TextureFileInfo::locate(itr->first, inDir);
+				Entry entry;
+				entry.info = &itr->second;
+				if (filename.empty() || !entry.image.load(filename.c_str())) {
+					log->warning(log::wTextureLoad, itr->first.c_str());
+					continue;
+				}
+				const float * const &b = itr->second.bounds;
+				// The used area in pixels, the rows depend on how the runtime will map the v coordinate to the image
+				entry.x1 = clamp((int)floor(b[0] * entry.image.width), 0, (int)entry.image.width - 1);
+				entry.x2 = clamp((int)ceil(b[2] * entry.image.width), entry.x1 + 1, (int)entry.image.width);
+				entry.y1 = clamp((int)floor((flipV ? 1.f - b[3] : b[1]) * entry.image.height), 0, (int)entry.image.height - 1);
+				entry.y2 = clamp((int)ceil((flipV ? 1.f - b[1] : b[3]) * entry.image.height), entry.y1 + 1, (int)entry.image.height);
+				const unsigned int w = (unsigned int)(entry.x2 - entry.x1) + 2 * padding, h = (unsigned int)(entry.y2 - entry.y1) + 2 * padding;
+				if (w > pageSize || h > pageSize)
+					continue;
+				rects.push_back(RectPacker::Rect(w, h, (unsigned int)entries.size()));
+				entries.push_back(entry);
+			}
+			// Packing a single texture only saves memory, but doesn't reduce texture switches
+			if (entries.size() < 2)
+				return 0;
+
+			RectPacker packer(pageSize);
+			const unsigned int pageCount = packer.pack(rects);
+			std::vector<Image> pages(pageCount);
+			std::vector<std::string> names(pageCount);
+			const std::string::size_type dot = outFile.find_last_of('.');
+			const std::string base = dot == std::string::npos || dot < outFile.find_last_of("/\\") + 1 ? outFile : outFile.substr(0, dot);
+			for (unsigned int i = 0; i < pageCount; i++) {
+				pages[i].resize(powerOfTwo(packer.pages[i].first), powerOfTwo(packer.pages[i].second));
+				std::stringstream ss;
+				ss << base << "_atlas" << (i + 1) << ".png";
+				names[i] = ss.str();
+			}
+
+			for (std::vector<RectPacker::Rect>::const_iterator itr = rects.begin(); itr != rects.end(); ++itr) {
+				Entry &entry = entries[itr->index];
+				Image &page = pages[itr->page];
+				const unsigned int x = itr->x + padding, y = itr->y + padding;
+				const unsigned int w = (unsigned int)(entry.x2 - entry.x1), h = (unsigned int)(entry.y2 - entry.y1);
+				page.draw(entry.image, entry.x1, entry.y1, w, h, x, y);
+				extrude(page, x, y, w, h);
+				// texcoord * scale + translation maps the original texture coordinates onto the page
+				const float scaleU = (float)entry.image.width / (float)page.width, scaleV = (float)entry.image.height / (float)page.height;
+				const float translationU = ((float)x - (float)entry.x1) / (float)page.width, translationV = ((float)y - (float)entry.y1) / (float)page.height;
+				for (std::vector<Material::Texture *>::iterator it = entry.info->textures.begin(); it != entry.info->textures.end(); ++it) {
+					(*it)->uvTranslation[0] = translationU;
+					(*it)->uvTranslation[1] = translationV;
+					(*it)->uvScale[0] = scaleU;
+					(*it)->uvScale[1] = scaleV;
+				}
+				entry.info->path = names[itr->page].substr(names[itr->page].find_last_of("/\\") + 1);
+				entry.info->source = names[itr->page];
+				entry.image = Image();
+			}
+
+			for (unsigned int i = 0; i < pageCount; i++)
+				if (!pages[i].save(names[i].c_str()))
+					log->warning(log::wTextureSave, names[i].c_str());
+			log->verbose(log::iTextureAtlas, (int)entries.size(), (int)pageCount);
+			return (unsigned int)entries.size();
+		}
+
+	private:
+		struct Entry {
+			readers::TextureFileInfo *info;
+			Image image;
+			int x1, y1, x2, y2;
+		};
+
+		fbxconv::log::Log *log;
+
+		static bool canPack(const std::string &filename, const readers::TextureFileInfo &info) {
+			static const float epsilon = 0.001f;
+			if (!Image::isPNG(filename) || !info.hasBounds() || info.textures.empty())
+				return false;
+			if (info.bounds[0] < -epsilon || info.bounds[1] < -epsilon || info.bounds[2] > 1.f + epsilon || info.bounds[3] > 1.f + epsilon)
+				return false;
+			for (std::vector<Material::Texture *>::const_iterator itr = info.textures.begin(); itr != info.textures.end(); ++itr)
+				if ((*itr)->uvTranslation[0] != 0.f || (*itr)->uvTranslation[1] != 0.f || (*itr)->uvScale[0] != 1.f || (*itr)->uvScale[1] != 1.f)
+					return false;
+			return true;
+		}
+
+		/** Repeat the edges of the area into the padding around it */
+		void extrude(Image &page, const unsigned int &x, const unsigned int &y, const unsigned int &w, const unsigned int &h) const {
+			for (unsigned int row = y; row < y + h; row++) {
+				for (unsigned int i = 1; i <= padding && i <= x; i++)
+					memcpy(page.pixel(x - i, row), page.pixel(x, row), 4);
+				for (unsigned int i = 0; i < padding && x + w + i < page.width; i++)
+					memcpy(page.pixel(x + w + i, row), page.pixel(x + w - 1, row), 4);
+			}
+			const unsigned int left = x < padding ? 0 : x - padding;
+			const unsigned int right = x + w + padding > page.width ? page.width : x + w + padding;
+			for (unsigned int i = 1; i <= padding && i <= y; i++)
+				memcpy(page.pixel(left, y - i), page.pixel(left, y), (right - left) * 4);
+			for (unsigned int i = 0; i < padding && y + h + i < page.height; i++)
+				memcpy(page.pixel(left, y + h + i), page.pixel(left, y + h - 1), (right - left) * 4);
+		}
+
+		static inline int clamp(const int &v, const int &min, const int &max) {
+			return v < min ? min : (v > max ? max : v);
+		}
+
+		static unsigned int powerOfTwo(const unsigned int &v) {
+			unsigned int result = 1;
+			while (result < v)
+				result <<= 1;
+			return result;
+		}
+	};
+}
+}
+
+#endif //FBXCONV_IMAGE_TEXTUREATLAS_H
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_IMAGE_TEXTUREPROCESSOR_H
+#define FBXCONV_IMAGE_TEXTUREPROCESSOR_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "Image.h"
+#include "KTX.h"
+#include "../util/thread.h"
+#include "../readers/TextureFileInfo.h"
+#include "../log/log.h"
+
+namespace fbxconv {
+namespace image {
+	/** Decodes each referenced PNG texture, limits its size, optionally premultiplies the alpha and generates the mipmaps.
+	 * The result is written next to the output file (as PNG, or KTX when it contains mipmaps) and the textures are updated
+	 * to reference it. The textures are processed concurrently. */
+	class TextureProcessor : public util::Job {
+	public:
+		/** The maximum width and height of a texture, or 0 to keep the original size */
+		const unsigned int maxSize;
+		const bool mipmaps;
+		const bool premultiplyAlpha;
+		/** The number of threads to use, or 0 to use the number of hardware threads */
+		const unsigned int threads;
+
+		TextureProcessor(fbxconv::log::Log * const &log, const unsigned int &maxSize, const bool &mipmaps, const bool &premultiplyAlpha, const unsigned int &threads = 0)
+			: maxSize(maxSize), mipmaps(mipmaps), premultiplyAlpha(premultiplyAlpha), threads(threads), log(log) {}
+
+		/** Process all textures, returns the number of files written */
+		unsigned int process(std::map<std::string, readers::TextureFileInfo> &textures, const std::string &inFile, const std::string &outFile) {
+			const std::string inDir = readers::TextureFileInfo::getDirectory(inFile);
+			const std::string outDir = readers::TextureFileInfo::getDirectory(outFile);
+			std::map<std::string, unsigned int> sources;
+			std::set<std::string> targets;
+			tasks.clear();
+			for (std::map<std::string, readers::TextureFileInfo>::iterator itr = textures.begin(); itr != textures.end(); ++itr) {
+				const bool generated = !itr->second.source.empty();
+				const std::string source = generated ? itr->second.source : readers::TextureFileInfo::locate(itr->first, inDir);
+				if (source.empty()) {
+					log->warning(log::wTextureLoad, itr->first.c_str());
+					continue;
+				}
+				if (!Image::isPNG(source)) {
+					log->warning(log::wTextureFormat, source.c_str());
+					continue;
+				}
+				std::map<std::string, unsigned int>::iterator it = sources.find(source);
+				if (it == sources.end()) {
+					it = sources.insert(std::make_pair(source, (unsigned int)tasks.size())).first;
+					tasks.push_back(Task());
+					Task &task = tasks.back();
+					task.source = source;
+					const std::string name = source.substr(source.find_last_of("/\\") + 1);
+					std::string target = outDir + name.substr(0, name.find_last_of('.'));
+					// Never overwrite the original texture
+					if (!generated && (target + ".png") == source)
+						target += "_processed";
+					// Textures with the same name in different directories must not be written to the same file
+					task.target = target + (mipmaps ? ".ktx" : ".png");
+					for (unsigned int n = 2; targets.find(task.target) != targets.end() || (!generated && task.target == source); n++) {
+						std::stringstream ss;
+						ss << target << "_" << n << (mipmaps ? ".ktx" : ".png");
+						task.target = ss.str();
+					}
+					targets.insert(task.target);
+				}
+				tasks[it->second].textures.push_back(&itr->second);
+			}
+
+			util::parallelFor(*this, (unsigned int)tasks.size(), threads);
+
+			unsigned int result = 0;
+			for (std::vector<Task>::const_iterator itr = tasks.begin(); itr != tasks.end(); ++itr) {
+				if (itr->error >= 0) {
+					log->warning(itr->error, itr->error == log::wTextureLoad ? itr->source.c_str() : itr->target.c_str());
+					continue;
+				}
+				const std::string path = itr->target.substr(itr->target.find_last_of("/\\") + 1);
+				for (std::vector<readers::TextureFileInfo *>::const_iterator it = itr->textures.begin(); it != itr->textures.end(); ++it) {
+					(*it)->path = path;
+					(*it)->source = itr->target;
+				}
+				result++;
+			}
+			log->verbose(log::iTextureProcessed, (int)result, (int)(threads > 0 ? threads : util::hardwareThreads()));
+			tasks.clear();
+			return result;
+		}
+
+		/** Process a single task, called concurrently, so it must not use the log */
+		virtual void execute(const unsigned int &index) {
+			Task &task = tasks[index];
+			std::vector<Image> levels(1);
+			if (!levels[0].load(task.source.c_str())) {
+				task.error = log::wTextureLoad;
+				return;
+			}
+			const unsigned int size = levels[0].width > levels[0].height ? levels[0].width : levels[0].height;
+			if (maxSize > 0 && size > maxSize) {
+				Image scaled;
+				const unsigned int w = (unsigned int)((unsigned long long)levels[0].width * maxSize / size);
+				const unsigned int h = (unsigned int)((unsigned long long)levels[0].height * maxSize / size);
+				levels[0].scale(scaled, w > 0 ? w : 1, h > 0 ? h : 1);
+				levels[0].pixels.swap(scaled.pixels);
+				levels[0].width = scaled.width;
+				levels[0].height = scaled.height;
+			}
+			// Premultiply before creating the mipmaps, so transparent pixels don't bleed their color into the smaller levels
+			if (premultiplyAlpha)
+				levels[0].premultiplyAlpha();
+			if (mipmaps) {
+				while (levels.back().width > 1 || levels.back().height > 1) {
+					levels.push_back(Image());
+					levels[levels.size() - 2].halve(levels.back());
+				}
+				if (!KTX::save(task.target.c_str(), levels))
+					task.error = log::wTextureSave;
+			}
+			else if (!levels[0].save(task.target.c_str()))
+				task.error = log::wTextureSave;
+		}
+
+	private:
+		struct Task {
+			std::string source;
+			std::string target;
+			std::vector<readers::TextureFileInfo *> textures;
+			/** The log code of the warning if the task failed, or -1 */
+			int error;
+			Task() : error(-1) {}
+		};
+
+		fbxconv::log::Log *log;
+		std::vector<Task> tasks;
+	};
+}
+}
+
+#endif //FBXCONV_IMAGE_TEXTUREPROCESSOR_H
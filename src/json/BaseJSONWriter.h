@@ -22,7 +22,6 @@
 
 #include <ostream>
 #include <fstream>
-#include <stack>
 #include <vector>
 #include <string>
 #include <cassert>
@@ -59,9 +58,16 @@ template <typename B, typename D> struct is_base_of
 
 
 class BaseJSONWriter;
+class JSONWriter;
+class UBJSONWriter;
 
+/** An object which writes itself to a writer. By default writing through a concrete writer is forwarded to the BaseJSONWriter
+ * overload. Objects which are written often can override the concrete overloads (usually with a template method on the writer
+ * type), so only the object is dispatched while each of its keys and values is written statically. */
 struct ConstSerializable {
 	virtual void serialize(BaseJSONWriter &writer) const = 0;
+	virtual void serialize(JSONWriter &writer) const;
+	virtual void serialize(UBJSONWriter &writer) const;
 };
 
 // The possible operations:
@@ -112,7 +118,15 @@ static const JSONOp<op_end>			 end;
 static const JSONOp<op_is>			 is;
 static const JSONOp<op_nul>			 nul;
 
-class BaseJSONWriter {
+/** The state of a writer: the block (object or array) being written and the blocks it is nested in. */
+class JSONWriterState {
+public:
+	unsigned int defaultDataLineSize;
+
+	JSONWriterState() : defaultDataLineSize(32), block(Block::ROOT) {
+		blocks.reserve(16);
+	}
+
 protected:
 	struct Block {
 		enum Type { ROOT = 0, OBJECT = 1, ARRAY = 2 };
@@ -123,99 +137,73 @@ protected:
 		unsigned int maxLineSize;
 		unsigned int lineSize;
 		bool wroteKey;
-		Block(const Block &rhs) 
-			: type(rhs.type), capacity(rhs.capacity), size(rhs.size), wroteKey(rhs.wroteKey), maxLineSize(rhs.maxLineSize), lineSize(rhs.lineSize) {}
 		Block(const Type &type, const long long &capacity = -1, const unsigned int maxLineSize = 0) 
 			: type(type), capacity(capacity), size(0), wroteKey(false), maxLineSize(maxLineSize), lineSize(0) {}
 	};
 
-private:
-	std::stack<Block> blocks;
+	/** The enclosing blocks, the current block is kept apart so writing a value only has to access that block */
+	std::vector<Block> blocks;
 	Block block;
+};
+
+/** Implements the writer (the nesting, separators, keys and the streaming syntax) on top of the tokens of Impl, which derives
+ * from this class. The tokens are called directly (Impl::emitXXX, see StaticJSONWriter), so they can be inlined, and all
+ * methods return Impl to keep chained calls statically dispatched. Base is JSONWriterState or a class derived from it. */
+template<class Impl, class Base> class JSONWriterCore : public Base {
+protected:
+	typedef typename Base::Block Block;
+	using Base::blocks;
+	using Base::block;
 
-	void nextValue(const bool &ispair, const bool &isblock) {
+private:
+	inline Impl &impl() {
+		return *static_cast<Impl *>(this);
+	}
+
+	inline void nextValue(const bool &ispair, const bool &isblock) {
 		assert(("Can only write key-value pairs within an object", !((ispair && (block.type != Block::OBJECT)) || (!ispair && (block.type == Block::OBJECT)))));
 		assert(("Must start with an array or an object", isblock || block.type != Block::ROOT));
 		assert(("Can only write one object or array per instance", block.size == 0 || block.type != Block::ROOT));
 		//assert(("Block capacity exceeded", block.capacity < 0 || block.size < block.capacity));
 
-		writeNextValue(block.size++ == 0, ++block.lineSize > block.maxLineSize);
+		impl().emitNextValue(block.size++ == 0, ++block.lineSize > block.maxLineSize);
 		if (block.lineSize > block.maxLineSize)
 			block.lineSize = 1;
 	}
 
-	BaseJSONWriter &openBlock(const Block::Type &type, const long long &capacity = -1, const unsigned int &lineSize = 0) {
+	Impl &openBlock(const typename Block::Type &type, const long long &capacity = -1, const unsigned int &lineSize = 0) {
 		assert(("Unknown block type", type == Block::OBJECT || type == Block::ARRAY));
 
 		if (!checkKey())
 			nextValue(inObject(), true);
 
-		blocks.push(block);
+		blocks.push_back(block);
 		block = Block(type, capacity, lineSize);
 
 		if (type == Block::OBJECT)
-			writeOpenObject(block.capacity < 0, block.capacity, block.capacity >= 0 && block.capacity <= block.maxLineSize);
+			impl().emitOpenObject(block.capacity < 0, block.capacity, block.capacity >= 0 && block.capacity <= block.maxLineSize);
 		else
-			writeOpenArray(block.capacity < 0, block.capacity, block.capacity >= 0 && block.capacity <= block.maxLineSize);
+			impl().emitOpenArray(block.capacity < 0, block.capacity, block.capacity >= 0 && block.capacity <= block.maxLineSize);
 			
-		return *this;
+		return impl();
 	}
 
-	BaseJSONWriter &closeBlock() {
+	Impl &closeBlock() {
 		assert(("Unmatched blocks", block.type != Block::ROOT && !blocks.empty()));
 		//assert(("Reserved capacity not reached yet", block.capacity < 0 || block.size == block.capacity));
 		assert(("Key written without value", !block.wroteKey));
 		assert(("Unknown block type", block.type == Block::OBJECT || block.type == Block::ARRAY));
 
 		if (block.type == Block::OBJECT)
-			writeCloseObject(block.capacity < 0, block.size, block.capacity >= 0 && block.capacity <= block.maxLineSize);
+			impl().emitCloseObject(block.capacity < 0, block.size, block.capacity >= 0 && block.capacity <= block.maxLineSize);
 		else
-			writeCloseArray(block.capacity < 0, block.size, block.capacity >= 0 && block.capacity <= block.maxLineSize);
+			impl().emitCloseArray(block.capacity < 0, block.size, block.capacity >= 0 && block.capacity <= block.maxLineSize);
 
-		block = blocks.top();
-		blocks.pop();
-		return *this;
+		block = blocks.back();
+		blocks.pop_back();
+		return impl();
 	}
 
-protected:
-	virtual void writeOpenObject(const bool &varsize, const long long &size, const bool &inl) = 0;
-	virtual void writeCloseObject(const bool &varsize, const long long &size, const bool &inl) = 0;
-	virtual void writeOpenArray(const bool &varsize, const long long &size, const bool &inl) = 0;
-	virtual void writeCloseArray(const bool &varsize, const long long &size, const bool &inl) = 0;
-	virtual void writeNextValue(const bool &first, const bool &newline) = 0;
-	virtual void writeNull() = 0;
-	virtual void writeValue(const char * const &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const bool &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const char &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const short &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const int &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const long &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const float &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const double &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const unsigned char &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const unsigned short &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const unsigned int &value, const bool &iskey = false) = 0;
-	virtual void writeValue(const unsigned long &value, const bool &iskey = false) = 0;
-	// If writeOpenXXXData returns false, it falls back on writing out an array
-	inline virtual bool writeOpenFloatData(const size_t& count) { return false; }
-	inline virtual bool writeOpenDoubleData(const size_t& count) { return false; }
-	inline virtual bool writeOpenShortData(const size_t& count) { return false; }
-	inline virtual bool writeOpenUShortData(const size_t& count) { return false; }
-	inline virtual bool writeOpenIntData(const size_t& count) { return false; }
-	inline virtual bool writeOpenUIntData(const size_t& count) { return false; }
-	inline virtual bool writeOpenLongData(const size_t& count) { return false; }
-	inline virtual bool writeOpenULongData(const size_t& count) { return false; }
-	inline virtual void writeFloatData(const float * const &values, const size_t &count) {}
-	inline virtual void writeDoubleData(const double * const &values, const size_t &count) {}
-	inline virtual void writeShortData(const short * const &values, const size_t &count) {}
-	inline virtual void writeUShortData(const unsigned short * const &values, const size_t &count) {}
-	inline virtual void writeIntData(const int * const &values, const size_t &count) {}
-	inline virtual void writeUIntData(const unsigned int * const &values, const size_t &count) {}
-	inline virtual void writeLongData(const long * const &values, const size_t &count) {}
-	inline virtual void writeULongData(const unsigned long * const &values, const size_t &count) {}
-	inline virtual void writeCloseData() {}
-
-private:
 	bool checkKey(const bool &allowKey = true) {
 		if (!inObject())
 			return false;
@@ -226,47 +214,31 @@ private:
 		return !block.wroteKey;
 	}
 
-	template<class T> inline bool openData(const T &dummy, const size_t &items) { return false; }
-	inline bool openData(const float &dummy, const size_t &items) { return writeOpenFloatData(items); }
-	inline bool openData(const double &dummy, const size_t &items) { return writeOpenDoubleData(items); }
-	inline bool openData(const short &dummy, const size_t &items) { return writeOpenShortData(items); }
-	inline bool openData(const unsigned short &dummy, const size_t &items) { return writeOpenUShortData(items); }
-	inline bool openData(const int &dummy, const size_t &items) { return writeOpenIntData(items); }
-	inline bool openData(const unsigned int &dummy, const size_t &items) { return writeOpenUIntData(items); }
-	inline bool openData(const long &dummy, const size_t &items) { return writeOpenLongData(items); }
-	inline bool openData(const unsigned long &dummy, const size_t &items) { return writeOpenULongData(items); }
-	template<class T> inline void dataItem(const T * const &value, const size_t &count) {}
-	inline void dataItem(const float * const &value, const size_t &count) { writeFloatData(value, count); }
-	inline void dataItem(const double * const &value, const size_t &count) { writeDoubleData(value, count); }
-	inline void dataItem(const short * const &value, const size_t &count) { writeShortData(value, count); }
-	inline void dataItem(const unsigned short * const &value, const size_t &count) { writeUShortData(value, count); }
-	inline void dataItem(const int * const &value, const size_t &count) { writeIntData(value, count); }
-	inline void dataItem(const unsigned int * const &value, const size_t &count) { writeUIntData(value, count); }
-	inline void dataItem(const long * const &value, const size_t &count) { writeLongData(value, count); }
-	inline void dataItem(const unsigned long * const &value, const size_t &count) { writeULongData(value, count); }
-	
-	template<class T, size_t n> inline void values(const T (&value)[n], const unsigned int &lineSize = 0) { values(&value[0], n, lineSize); }
-	template<class T> inline void values(const T * const &values, const size_t &count, const unsigned int &lineSize = 0) {
-		if (openData(values[0], count)) {
-			dataItem(values, count);
-			writeCloseData();
+protected:
+	// Writers which can write an array of scalar values at once implement these, if emitOpenData returns false
+	// the values are written as an array instead
+	template<class T> inline bool emitOpenData(const T * const &, const size_t &) { return false; }
+	template<class T> inline void emitData(const T * const &, const size_t &) {}
+	inline void emitCloseData() {}
+
+	/** Write an array of the same type of scalar values, the separator (if any) is already written */
+	template<class T> inline void emitValues(const T * const &values, const size_t &count, const unsigned int &lineSize) {
+		if (impl().emitOpenData(values, count)) {
+			impl().emitData(values, count);
+			impl().emitCloseData();
 		} else {
 			checkKey();
 			arr(values, count, lineSize);
 		}
 	}
 
+private:
 	template<class T> inline void values(const std::vector<T> &values, const unsigned int &lineSize = 0) {
-		const size_t count = values.size();
-		const size_t bytes = count * sizeof(T);
-		if (count > 0 && openData(values[0], count)) {
-			for (typename std::vector<T>::const_iterator it = values.begin(); it != values.end(); ++it)
-				dataItem(&(*it), 1);
-			writeCloseData();
-		} else {
+		if (values.empty()) {
 			checkKey();
 			arr(values, lineSize);
-		}
+		} else
+			impl().emitValues(&values[0], values.size(), lineSize);
 	}
 
 	template<class T, size_t n> inline void valueArray(const T (&value)[n], const bool &iskey = false) { valueArray(&value[0], n, iskey); }
@@ -275,19 +247,19 @@ private:
 
 	//template<class T> inline void value(const T &value, const bool &iskey = false) { assert(("Not a serializable value", false)); }
 	//template<class T> inline void value(const T * const &value, const bool &iskey = false) { assert(("Not a serializable value", false)); }
-	inline void value(const char * const &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const bool &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const char &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const short &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const int &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const long &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const float &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const double &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const std::string &value, const bool &iskey) { writeValue(value.c_str(), iskey); }
-	inline void value(const unsigned char &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const unsigned short &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const unsigned int &value, const bool &iskey) { writeValue(value, iskey); }
-	inline void value(const unsigned long &value, const bool &iskey) { writeValue(value, iskey); }
+	inline void value(const char * const &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const bool &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const char &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const short &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const int &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const long &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const float &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const double &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const std::string &value, const bool &iskey) { impl().emitValue(value.c_str(), iskey); }
+	inline void value(const unsigned char &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const unsigned short &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const unsigned int &value, const bool &iskey) { impl().emitValue(value, iskey); }
+	inline void value(const unsigned long &value, const bool &iskey) { impl().emitValue(value, iskey); }
 
 	template<class V, class N> inline void value(const V &value, const N &name, const bool &iskey = false) { assert(("Not implemented", false)); }
 
@@ -304,31 +276,24 @@ private:
 		if (!checkKey()) nextValue(inObject(), false);
 		value(v, block.wroteKey);
 	}
+	// A serializable writes itself to the overload of Impl, which is the concrete writer unless writing through BaseJSONWriter
 	void __val(const ConstSerializable &v) {
-		v.serialize(*this);
+		v.serialize(impl());
 	}
 	void __ptr(const ConstSerializable *v) {
-		v->serialize(*this);
+		v->serialize(impl());
 	}
 public:
-	unsigned int defaultDataLineSize;
-
-	BaseJSONWriter() : block(Block::ROOT), defaultDataLineSize(32) {}
-
-	virtual ~BaseJSONWriter() {
-		assert(("Unclosed object or array", !inArray() && !inObject()));
-	}
-
 	/** Start writing an array, make sure to call .end(); when finished. */
-	inline BaseJSONWriter &arr(const long long &capacity = -1, const unsigned int &maxLineSize = 0)	{ 
+	inline Impl &arr(const long long &capacity = -1, const unsigned int &maxLineSize = 0)	{ 
 		return openBlock(Block::ARRAY, capacity, maxLineSize);  
 	}
 	/** Start writing an object, make sure to call .end(); when finished. */
-	inline BaseJSONWriter &obj(const long long &capacity = -1, const unsigned int &maxLineSize = 0)	{
+	inline Impl &obj(const long long &capacity = -1, const unsigned int &maxLineSize = 0)	{
 		return openBlock(Block::OBJECT, capacity, maxLineSize);
 	}
 	/** End the last started array or object */
-	inline BaseJSONWriter &end() {
+	inline Impl &end() {
 		return closeBlock();
 	}
 	/** Check if currently writing an array */
@@ -340,150 +305,243 @@ public:
 		return block.type == Block::OBJECT;
 	}
 	/** Separate between key and value (not required, pure semantics to keep clean code) */
-	BaseJSONWriter &is() {
+	Impl &is() {
 		assert(("No key written to assign", inObject() && block.wroteKey));
-		return *this;
+		return impl();
 	}
 	/** Write a null value */
-	BaseJSONWriter &nul() {
+	Impl &nul() {
 		if (!checkKey(false)) nextValue(inObject(), false);
-		writeNull();
-		return *this;
+		impl().emitNull();
+		return impl();
 	}
 	/* Write a single value */
-	template<class T> BaseJSONWriter &val(const T &v) {
+	template<class T> Impl &val(const T &v) {
 		_val(v);
-		return *this;
+		return impl();
 	}
-	/** WIP Write an enum value, where v is the scalar value and name is the (textual) representation of it */
-	/*template<class V, class N> BaseJSONWriter &val(const V &v, const N &name) {
-		if (!checkKey()) nextValue(inObject(), false);
-		value<T>(v, name, block.wroteKey);
-		return *this;
-	}*/
 	/* Write a fixed length array of values (usually a string) */
-	template<class T, size_t n> BaseJSONWriter &val(const T (&v)[n]) {
+	template<class T, size_t n> Impl &val(const T (&v)[n]) {
 		if (!checkKey()) nextValue(inObject(), false);
 		valueArray<T, n>(v, block.wroteKey);
-		return *this;
+		return impl();
 	}
-	/** WIP Write an enum value, where v is the scalar value and n is the (textual) representation of it */
-	/*template<class V, class N, size_t n> BaseJSONWriter &val(const V &v, const N (&name)[n]) {
-		if (!checkKey()) nextValue(inObject(), false);
-		value<T>(v, name, block.wroteKey);
-		return *this;
-	}*/
 	/** Open an array, write the values and end the array, consider using .data() instead. */
-	template<class T> BaseJSONWriter &arr(const T * const &values, const size_t &size, const unsigned int &lineSize = 0) {
+	template<class T> Impl &arr(const T * const &values, const size_t &size, const unsigned int &lineSize = 0) {
 		arr(size, lineSize);
 		for (size_t i = 0; i < size; i++)
 			val(values[i]);
 		end();
-		return *this;
+		return impl();
 	}
 	/** Open an array, write the values and end the array, consider using .data() instead. */
-	template<class T> BaseJSONWriter &arr(const std::vector<T> &values, const unsigned int &lineSize = 0) {
+	template<class T> Impl &arr(const std::vector<T> &values, const unsigned int &lineSize = 0) {
 		arr(values.size(), lineSize);
 		for (typename std::vector<T>::const_iterator it = values.begin(); it != values.end(); ++it)
 			val(*it);
 		end();
-		return *this;
+		return impl();
 	}
 	/** Write an array of the same type of scalar values in the most optimal way. */
-	template<class T> inline BaseJSONWriter &data(const T * const &v, const size_t &size, const unsigned int &lineSize = useDefaultSize) {
+	template<class T> inline Impl &data(const T * const &v, const size_t &size, const unsigned int &lineSize = useDefaultSize) {
 		if (!checkKey(false)) nextValue(inObject(), false);
-		values(v, size, lineSize == useDefaultSize ? defaultDataLineSize : lineSize);
-		return *this;
+		impl().emitValues(v, size, lineSize == useDefaultSize ? this->defaultDataLineSize : lineSize);
+		return impl();
 	}
 	/** Write an fixed size array of the same type of scalar values in the most optimal way. */
-	template<class T, size_t n> BaseJSONWriter &data(const T (&v)[n], const unsigned int &lineSize = useDefaultSize) {
+	template<class T, size_t n> Impl &data(const T (&v)[n], const unsigned int &lineSize = useDefaultSize) {
 		if (!checkKey(false)) nextValue(inObject(), false);
-		values(v, lineSize == useDefaultSize ? defaultDataLineSize : lineSize);
-		return *this;
+		impl().emitValues(&v[0], n, lineSize == useDefaultSize ? this->defaultDataLineSize : lineSize);
+		return impl();
 	}
 	/** Write an array of the same type of scalar values in the most optimal way. */
-	template<class T> inline BaseJSONWriter &data(const std::vector<T> &v, const unsigned int &lineSize = useDefaultSize) {
+	template<class T> inline Impl &data(const std::vector<T> &v, const unsigned int &lineSize = useDefaultSize) {
 		if (!checkKey(false)) nextValue(inObject(), false);
-		values(v, lineSize == useDefaultSize ? defaultDataLineSize : lineSize);
-		return *this;
+		values(v, lineSize == useDefaultSize ? this->defaultDataLineSize : lineSize);
+		return impl();
 	}
 	/** Write a key - value pair, sugar for .val(key).is().val(value); */
-	template<class K, class V> inline BaseJSONWriter &pair(const K &key, const V &value) {
+	template<class K, class V> inline Impl &pair(const K &key, const V &value) {
 		return val(key).is().val(value);
 	}
 	/** Write a key - value pair, sugar for .val(key).is().val(value); */
-	template<class K, class V, size_t n> inline BaseJSONWriter &pair(const K &key, const V (&value)[n]) {
+	template<class K, class V, size_t n> inline Impl &pair(const K &key, const V (&value)[n]) {
 		return val(key).is().val(value);
 	}
 	/** Write a key - value pair, sugar for .val(p.first).is().val(p.second); */
-	template<class K, class V> inline BaseJSONWriter &pair(const std::pair<K, V> &p) {
+	template<class K, class V> inline Impl &pair(const std::pair<K, V> &p) {
 		return pair(p.first, p.second);
 	}
 	/** Write a key - array pair, sugar for .val(key).is().data(values, size); */
-	template<class K, class V> inline BaseJSONWriter &pair(const K * const &key, const V * const &values, const size_t &size) {
+	template<class K, class V> inline Impl &pair(const K * const &key, const V * const &values, const size_t &size) {
 		return val(key).is().data(values, size);
 	}
 	/** Write a key - array pair, sugar for .val(key).is().data(values, size); */
-	template<class K, class V> inline BaseJSONWriter &pair(const K * const &key, const std::vector<V> &values) {
+	template<class K, class V> inline Impl &pair(const K * const &key, const std::vector<V> &values) {
 		return val(key).is().data(values);
 	}
 
 public:
-	inline BaseJSONWriter &op(const JSONOp<op_is> &op)		{ return is(); }
-	inline BaseJSONWriter &op(const JSONOp<op_nul> &op)		{ return nul(); }
-	inline BaseJSONWriter &op(const JSONOp<op_end> &op)		{ return end(); }
-	inline BaseJSONWriter &op(const JSONBlockOp<op_arr> &op)	{ return arr(op.capacity); }
-	inline BaseJSONWriter &op(const JSONBlockOp<op_obj> &op)	{ return obj(op.capacity); }
-	template<class P> inline BaseJSONWriter &op(const JSONPtrOp<op_dat, P> &op)	{ return data(op.ptr, op.size); }
+	inline Impl &op(const JSONOp<op_is> &op)		{ return is(); }
+	inline Impl &op(const JSONOp<op_nul> &op)		{ return nul(); }
+	inline Impl &op(const JSONOp<op_end> &op)		{ return end(); }
+	inline Impl &op(const JSONBlockOp<op_arr> &op)	{ return arr(op.capacity); }
+	inline Impl &op(const JSONBlockOp<op_obj> &op)	{ return obj(op.capacity); }
+	template<class P> inline Impl &op(const JSONPtrOp<op_dat, P> &op)	{ return data(op.ptr, op.size); }
 
 public:
 	/** Start writing an array, sugar for .arr(capacity); */
-	inline BaseJSONWriter &operator[](const long long &capacity) { return arr(capacity); }
+	inline Impl &operator[](const long long &capacity) { return arr(capacity); }
 	/** Stream a single value, sugar for .val(value); */
-	template<class T> inline BaseJSONWriter &operator<<(const T &v)	{ return val(v);		}
+	template<class T> inline Impl &operator<<(const T &v)	{ return val(v);		}
 	/** Stream a single (array) value, sugar for .val(value); */
-	template<class T> inline BaseJSONWriter &operator,(const T &v)	{ return val(v);		}
+	template<class T> inline Impl &operator,(const T &v)	{ return val(v);		}
 	/** Stream a single value after writing a key, sugar for .is().val(value); */
-	template<class T> inline BaseJSONWriter &operator=(const T &v)	{ return is().val(v);}
+	template<class T> inline Impl &operator=(const T &v)	{ return is().val(v);}
 	/** Stream a fixed length array (usually a string) as value, sugar for .val(v); */
-	template<class T, size_t n> inline BaseJSONWriter &operator<<(const T (&v)[n])	{ return val(v);		}
+	template<class T, size_t n> inline Impl &operator<<(const T (&v)[n])	{ return val(v);		}
 	/** Stream a fixed length array (usually a string) as (array) value, sugar for .val(v); */
-	template<class T, size_t n> inline BaseJSONWriter &operator,(const T (&v)[n])	{ return val(v);		}
+	template<class T, size_t n> inline Impl &operator,(const T (&v)[n])	{ return val(v);		}
 	/** Stream a fixed length array (usually a string) as value after writing a key, sugar for .is().val(v); */
-	template<class T, size_t n> inline BaseJSONWriter &operator=(const T (&v)[n])	{ return is().val(v);	}
+	template<class T, size_t n> inline Impl &operator=(const T (&v)[n])	{ return is().val(v);	}
 	/** Stream an array as data, sugar for .data(v); */
-	template<class T> inline BaseJSONWriter &operator<<(const std::vector<T> &v){ return data(v);		}
+	template<class T> inline Impl &operator<<(const std::vector<T> &v){ return data(v);		}
 	/** Stream an array as data, sugar for .data(v); */
-	template<class T> inline BaseJSONWriter &operator,(const std::vector<T> &v)	{ return data(v);		}
+	template<class T> inline Impl &operator,(const std::vector<T> &v)	{ return data(v);		}
 	/** Stream an array as data after writing a key, sugar for .is.data(v); */
-	template<class T> inline BaseJSONWriter &operator=(const std::vector<T> &v)	{ return is().data(v);	}
+	template<class T> inline Impl &operator=(const std::vector<T> &v)	{ return is().data(v);	}
 	/** Stream an array as data, sugar for .data(v); */
-	template<class T> inline BaseJSONWriter &operator<<(const std::vector<T *> &v){ return arr(v);		}
+	template<class T> inline Impl &operator<<(const std::vector<T *> &v){ return arr(v);		}
 	/** Stream an array as data, sugar for .data(v); */
-	template<class T> inline BaseJSONWriter &operator,(const std::vector<T *> &v)	{ return arr(v);		}
+	template<class T> inline Impl &operator,(const std::vector<T *> &v)	{ return arr(v);		}
 	/** Stream an array as data after writing a key, sugar for .is.data(v); */
-	template<class T> inline BaseJSONWriter &operator=(const std::vector<T *> &v)	{ return is().arr(v);	}
+	template<class T> inline Impl &operator=(const std::vector<T *> &v)	{ return is().arr(v);	}
 	/** Stream an operator, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator<<(const JSONOp<T> &v){ return op(v); }
+	template<const char T> inline Impl &operator<<(const JSONOp<T> &v){ return op(v); }
 	/** Stream an operator, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator,(const JSONOp<T> &v)	{ return op(v); }
+	template<const char T> inline Impl &operator,(const JSONOp<T> &v)	{ return op(v); }
 	/** Stream an operator after writing a key, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator=(const JSONOp<T> &v){ return is().op(v); }
+	template<const char T> inline Impl &operator=(const JSONOp<T> &v){ return is().op(v); }
 	/** Stream an operator, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator<<(const JSONBlockOp<T> &v){ return op(v); }
+	template<const char T> inline Impl &operator<<(const JSONBlockOp<T> &v){ return op(v); }
 	/** Stream an operator, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator,(const JSONBlockOp<T> &v)	{ return op(v); }
+	template<const char T> inline Impl &operator,(const JSONBlockOp<T> &v)	{ return op(v); }
 	/** Stream an operator after writing a key, sugar .op(v) */
-	template<const char T> inline BaseJSONWriter &operator=(const JSONBlockOp<T> &v){ return is().op(v); }
+	template<const char T> inline Impl &operator=(const JSONBlockOp<T> &v){ return is().op(v); }
 	/** Stream an operator, sugar .op(v) */
-	template<const char T, class P> inline BaseJSONWriter &operator<<(const JSONPtrOp<T, P> &v){ return op(v); }
+	template<const char T, class P> inline Impl &operator<<(const JSONPtrOp<T, P> &v){ return op(v); }
 	/** Stream an operator, sugar .op(v) */
-	template<const char T, class P> inline BaseJSONWriter &operator,(const JSONPtrOp<T, P> &v)	{ return op(v); }
+	template<const char T, class P> inline Impl &operator,(const JSONPtrOp<T, P> &v)	{ return op(v); }
 	/** Stream an operator after writing a key, sugar .op(v) */
-	template<const char T, class P> inline BaseJSONWriter &operator=(const JSONPtrOp<T, P> &v){ return is().op(v); }
+	template<const char T, class P> inline Impl &operator=(const JSONPtrOp<T, P> &v){ return is().op(v); }
+
+};
+
+/** The writer a ConstSerializable writes itself to, each token is dispatched to the virtual writeXXX methods. Writers
+ * implement these by deriving from StaticJSONWriter. */
+class BaseJSONWriter : public JSONWriterCore<BaseJSONWriter, JSONWriterState> {
+	friend class JSONWriterCore<BaseJSONWriter, JSONWriterState>;
+	typedef JSONWriterCore<BaseJSONWriter, JSONWriterState> Core;
+public:
+	// The implicit assignment operator would hide the streaming syntax
+	using Core::operator=;
+
+	virtual ~BaseJSONWriter() {
+		assert(("Unclosed object or array", !inArray() && !inObject()));
+	}
+
+protected:
+	virtual void writeOpenObject(const bool &varsize, const long long &size, const bool &inl) = 0;
+	virtual void writeCloseObject(const bool &varsize, const long long &size, const bool &inl) = 0;
+	virtual void writeOpenArray(const bool &varsize, const long long &size, const bool &inl) = 0;
+	virtual void writeCloseArray(const bool &varsize, const long long &size, const bool &inl) = 0;
+	virtual void writeNextValue(const bool &first, const bool &newline) = 0;
+	virtual void writeNull() = 0;
+	virtual void writeValue(const char * const &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const bool &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const char &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const short &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const int &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const long &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const float &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const double &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const unsigned char &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const unsigned short &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const unsigned int &value, const bool &iskey = false) = 0;
+	virtual void writeValue(const unsigned long &value, const bool &iskey = false) = 0;
+	// Write an array of values at once, so only the array itself (not each value) is dispatched
+	virtual void writeValues(const float * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const double * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const short * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const unsigned short * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const int * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const unsigned int * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const long * const &values, const size_t &count, const unsigned int &lineSize) = 0;
+	virtual void writeValues(const unsigned long * const &values, const size_t &count, const unsigned int &lineSize) = 0;
 
+private:
+	inline void emitOpenObject(const bool &varsize, const long long &size, const bool &inl) { writeOpenObject(varsize, size, inl); }
+	inline void emitCloseObject(const bool &varsize, const long long &size, const bool &inl) { writeCloseObject(varsize, size, inl); }
+	inline void emitOpenArray(const bool &varsize, const long long &size, const bool &inl) { writeOpenArray(varsize, size, inl); }
+	inline void emitCloseArray(const bool &varsize, const long long &size, const bool &inl) { writeCloseArray(varsize, size, inl); }
+	inline void emitNextValue(const bool &first, const bool &newline) { writeNextValue(first, newline); }
+	inline void emitNull() { writeNull(); }
+	template<class T> inline void emitValue(const T &value, const bool &iskey) { writeValue(value, iskey); }
+	template<class T> inline void emitValues(const T * const &values, const size_t &count, const unsigned int &lineSize) { Core::emitValues(values, count, lineSize); }
+	inline void emitValues(const float * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const double * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const short * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const unsigned short * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const int * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const unsigned int * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const long * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+	inline void emitValues(const unsigned long * const &values, const size_t &count, const unsigned int &lineSize) { writeValues(values, count, lineSize); }
+};
+
+/** Base class of the writers, Impl implements the tokens as non-virtual emitXXX methods (see JSONWriter). Writing through Impl
+ * calls these directly, writing through BaseJSONWriter (e.g. by a ConstSerializable) calls them through the virtual methods. */
+template<class Impl> class StaticJSONWriter : public JSONWriterCore<Impl, BaseJSONWriter> {
+public:
+	using JSONWriterCore<Impl, BaseJSONWriter>::operator=;
+
+private:
+	inline Impl &impl() {
+		return *static_cast<Impl *>(this);
+	}
+
+protected:
+	virtual void writeOpenObject(const bool &varsize, const long long &size, const bool &inl) { impl().emitOpenObject(varsize, size, inl); }
+	virtual void writeCloseObject(const bool &varsize, const long long &size, const bool &inl) { impl().emitCloseObject(varsize, size, inl); }
+	virtual void writeOpenArray(const bool &varsize, const long long &size, const bool &inl) { impl().emitOpenArray(varsize, size, inl); }
+	virtual void writeCloseArray(const bool &varsize, const long long &size, const bool &inl) { impl().emitCloseArray(varsize, size, inl); }
+	virtual void writeNextValue(const bool &first, const bool &newline) { impl().emitNextValue(first, newline); }
+	virtual void writeNull() { impl().emitNull(); }
+	virtual void writeValue(const char * const &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const bool &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const char &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const short &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const int &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const long &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const float &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const double &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const unsigned char &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const unsigned short &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const unsigned int &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValue(const unsigned long &value, const bool &iskey = false) { impl().emitValue(value, iskey); }
+	virtual void writeValues(const float * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const double * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const short * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const unsigned short * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const int * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const unsigned int * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const long * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
+	virtual void writeValues(const unsigned long * const &values, const size_t &count, const unsigned int &lineSize) { impl().emitValues(values, count, lineSize); }
 };
 
 }
 
+// The concrete writers define the default ConstSerializable overloads, so these are available wherever it's used
+#include "JSONWriter.h"
+#include "UBJSONWriter.h"
+
 #endif //JSON_BASEJSONWRITER_H
\ No newline at end of file
@@ -24,7 +24,9 @@
 
 namespace json {
 
-class JSONWriter : public BaseJSONWriter {
+class JSONWriter : public StaticJSONWriter<JSONWriter> {
+	friend class JSONWriterCore<JSONWriter, BaseJSONWriter>;
+	friend class StaticJSONWriter<JSONWriter>;
 public:
 	const char *newline;
 	const char *indent;
@@ -37,7 +39,9 @@ public:
 public:
 	std::ostream &stream;
 
-	JSONWriter(std::ostream &stream) : BaseJSONWriter(), stream(stream), indentCount(0), 
+	using StaticJSONWriter<JSONWriter>::operator=;
+
+	JSONWriter(std::ostream &stream) : StaticJSONWriter<JSONWriter>(), stream(stream), indentCount(0), 
 		newline("\r\n"), indent("\t"), openObject("{"), closeObject("}"), openArray("["), closeArray("]"), keySeparator(": "), valueSeparator(", ")
 	{}
 protected:
@@ -48,77 +52,77 @@ protected:
 		for (int i = 0; i < indentCount; i++)
 			stream << indent;
 	}
-	virtual void writeOpenObject(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitOpenObject(const bool &varsize, const long long &size, const bool &inl) {
 		stream << openObject;
 		++indentCount;
 		if (!inl)
 			nextline();
 	}
-	virtual void writeCloseObject(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitCloseObject(const bool &varsize, const long long &size, const bool &inl) {
 		if (--indentCount < 0)
 			indentCount = 0;
 		if (!inl)
 			nextline();
 		stream << closeObject;
 	}
-	virtual void writeOpenArray(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitOpenArray(const bool &varsize, const long long &size, const bool &inl) {
 		stream << openArray;
 		++indentCount;
 		if (!inl)
 			nextline();
 	}
-	virtual void writeCloseArray(const bool &varsize, const long long &size, const bool &inl) {		
+	inline void emitCloseArray(const bool &varsize, const long long &size, const bool &inl) {		
 		if (--indentCount < 0)
 			indentCount = 0;
 		if (!inl)
 			nextline();
 		stream << closeArray;
 	}
-	virtual void writeNextValue(const bool &first, const bool &nl) {
+	inline void emitNextValue(const bool &first, const bool &nl) {
 		if (!first) {
 			stream << valueSeparator;
 			if (nl)
 				nextline();
 		}
 	}
-	virtual void writeNull() {
+	inline void emitNull() {
 		stream << "null";
 	}
-	virtual void writeValue(const char * const &value, const bool &iskey = false) {
+	inline void emitValue(const char * const &value, const bool &iskey = false) {
 		stream << "\"" << value << "\"";
 		if (iskey)
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const bool &value, const bool &iskey = false) {
+	inline void emitValue(const bool &value, const bool &iskey = false) {
 		stream << (value ? "true" : "false");
 		if (iskey)
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const char &value, const bool &iskey = false) {
-		writeValue((int)value, iskey);
+	inline void emitValue(const char &value, const bool &iskey = false) {
+		emitValue((int)value, iskey);
 	}
 
-	virtual void writeValue(const short &value, const bool &iskey = false) {
-		writeValue((int)value, iskey);
+	inline void emitValue(const short &value, const bool &iskey = false) {
+		emitValue((int)value, iskey);
 	}
 
-	virtual void writeValue(const int &value, const bool &iskey = false) {
+	inline void emitValue(const int &value, const bool &iskey = false) {
 		sprintf(tmp, "% 3i", value);
 		stream << tmp;
 		if (iskey)
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const long &value, const bool &iskey = false) {
+	inline void emitValue(const long &value, const bool &iskey = false) {
 		sprintf(tmp, "% 3i", value);
 		stream << tmp;
 		if (iskey)
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const float &value, const bool &iskey = false) {
+	inline void emitValue(const float &value, const bool &iskey = false) {
 		if ((value * 0) != 0) {
 			const unsigned int t = (*(unsigned int*)&value) & 0xfeffffff;
 			sprintf(tmp, "% 8f", *(float*)&t);
@@ -129,26 +133,26 @@ protected:
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const double &value, const bool &iskey = false) {
+	inline void emitValue(const double &value, const bool &iskey = false) {
 		sprintf(tmp, "% 8f", value);
 		stream << tmp;
 		if (iskey)
 			stream << keySeparator;
 	}
 
-	virtual void writeValue(const unsigned char &value, const bool &iskey = false) {
-		writeValue((int)value, iskey);
+	inline void emitValue(const unsigned char &value, const bool &iskey = false) {
+		emitValue((int)value, iskey);
 	}
-	virtual void writeValue(const unsigned short &value, const bool &iskey = false) {
-		writeValue((int)value, iskey);
+	inline void emitValue(const unsigned short &value, const bool &iskey = false) {
+		emitValue((int)value, iskey);
 	}
-	virtual void writeValue(const unsigned int &value, const bool &iskey = false) {
+	inline void emitValue(const unsigned int &value, const bool &iskey = false) {
 		sprintf(tmp, "% 3i", value);
 		stream << tmp;
 		if (iskey)
 			stream << keySeparator;
 	}
-	virtual void writeValue(const unsigned long &value, const bool &iskey = false) {
+	inline void emitValue(const unsigned long &value, const bool &iskey = false) {
 		sprintf(tmp, "% 3i", value);
 		stream << tmp;
 		if (iskey)
@@ -156,6 +160,10 @@ protected:
 	}
 };
 
+inline void ConstSerializable::serialize(JSONWriter &writer) const {
+	serialize(static_cast<BaseJSONWriter &>(writer));
+}
+
 }
 
 #endif //JSON_JSONWRITER_H
\ No newline at end of file
@@ -20,6 +20,8 @@
 #ifndef JSON_UBJSON_H
 #define JSON_UBJSON_H
 
+#include <string.h>
+
 namespace json {
 
 #define UBJSON_TYPE_NULL		'Z'
@@ -65,9 +67,10 @@ template<> inline void swap<8>(char * const &data) {
 	SWAP(data[3], data[4], tmp);
 }
 
-char swap_data[8];
 template<typename T, size_t n> struct Swapper {
 	static const char *swap(const T &v) {
+		// Local to the function, so the header can be included by multiple translation units
+		static char swap_data[8];
 		assert(("Data too big", n<=8));
 		memcpy(&swap_data[0], &v, n);
 		json::swap<n>(&swap_data[0]);
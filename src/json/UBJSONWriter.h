@@ -21,16 +21,21 @@
 #define JSON_UBJSONWRITER_H
 
 #include <stdio.h>
+#include <string.h>
 #include "BaseJSONWriter.h"
 #include "UBJSON.h"
 
 namespace json {
 
-class UBJSONWriter : public BaseJSONWriter {
+class UBJSONWriter : public StaticJSONWriter<UBJSONWriter> {
+	friend class JSONWriterCore<UBJSONWriter, BaseJSONWriter>;
+	friend class StaticJSONWriter<UBJSONWriter>;
 public:
 	std::ostream &stream;
 
-	UBJSONWriter(std::ostream &stream) : BaseJSONWriter(), stream(stream) {}
+	using StaticJSONWriter<UBJSONWriter>::operator=;
+
+	UBJSONWriter(std::ostream &stream) : StaticJSONWriter<UBJSONWriter>(), stream(stream) {}
 private:
 	template<typename T> inline void write(const T &v) { write<T, sizeof(T)>(v); }
 	template<typename T, size_t n> void write(const T &v) {
@@ -44,24 +49,24 @@ private:
 			stream.write((const char *)&v, n);*/
 	}
 protected:
-	virtual void writeOpenObject(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitOpenObject(const bool &varsize, const long long &size, const bool &inl) {
 		stream << "{";
 	}
-	virtual void writeCloseObject(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitCloseObject(const bool &varsize, const long long &size, const bool &inl) {
 		stream << "}";
 	}
-	virtual void writeOpenArray(const bool &varsize, const long long &size, const bool &inl) {
+	inline void emitOpenArray(const bool &varsize, const long long &size, const bool &inl) {
 		stream << "[";
 	}
-	virtual void writeCloseArray(const bool &varsize, const long long &size, const bool &inl) {		
+	inline void emitCloseArray(const bool &varsize, const long long &size, const bool &inl) {		
 		stream << "]";
 	}
-	virtual void writeNextValue(const bool &first, const bool &nl) {
+	inline void emitNextValue(const bool &first, const bool &nl) {
 	}
-	virtual void writeNull() {
+	inline void emitNull() {
 		stream << UBJSON_TYPE_NULL;
 	}
-	virtual void writeValue(const char * const &value, const bool &iskey = false) {
+	inline void emitValue(const char * const &value, const bool & = false) {
 		size_t len = strlen(value);
 		if (len < 256) {
 			stream << UBJSON_TYPE_STRING1;
@@ -73,46 +78,46 @@ protected:
 			stream.write(value, len);
 		}
 	}
-	virtual void writeValue(const bool &value, const bool &iskey = false) {
+	inline void emitValue(const bool &value, const bool & = false) {
 		stream << (value ? UBJSON_TYPE_TRUE : UBJSON_TYPE_FALSE);
 	}
-	virtual void writeValue(const char &value, const bool &iskey = false) {
+	inline void emitValue(const char &value, const bool & = false) {
 		stream << UBJSON_TYPE_BYTE;
 		write(value);
 	}
-	virtual void writeValue(const short &value, const bool &iskey = false) {
+	inline void emitValue(const short &value, const bool & = false) {
 		stream << UBJSON_TYPE_SHORT;
 		write(value);
 	}
-	virtual void writeValue(const int &value, const bool &iskey = false) {
+	inline void emitValue(const int &value, const bool & = false) {
 		stream << UBJSON_TYPE_INT;
 		write(value);
 	}
-	virtual void writeValue(const long &value, const bool &iskey = false) {
+	inline void emitValue(const long &value, const bool & = false) {
 		stream << UBJSON_TYPE_LONG;
 		write(value);
 	}
-	virtual void writeValue(const float &value, const bool &iskey = false) {
+	inline void emitValue(const float &value, const bool & = false) {
 		stream << UBJSON_TYPE_FLOAT;
 		write(value);
 	}
-	virtual void writeValue(const double &value, const bool &iskey = false) {
+	inline void emitValue(const double &value, const bool & = false) {
 		stream << UBJSON_TYPE_DOUBLE;
 		write(value);
 	}
-	virtual void writeValue(const unsigned char &value, const bool &iskey = false) {
-		writeValue(*(char*)&value, iskey);
+	inline void emitValue(const unsigned char &value, const bool &iskey = false) {
+		emitValue(*(char*)&value, iskey);
 	}
-	virtual void writeValue(const unsigned short &value, const bool &iskey = false) {
-		writeValue(*(short*)&value, iskey);
+	inline void emitValue(const unsigned short &value, const bool &iskey = false) {
+		emitValue(*(short*)&value, iskey);
 	}
-	virtual void writeValue(const unsigned int &value, const bool &iskey = false) {
-		writeValue(*(int*)&value, iskey);
+	inline void emitValue(const unsigned int &value, const bool &iskey = false) {
+		emitValue(*(int*)&value, iskey);
 	}
-	virtual void writeValue(const unsigned long &value, const bool &iskey = false) {
-		writeValue(*(long*)&value, iskey);
+	inline void emitValue(const unsigned long &value, const bool &iskey = false) {
+		emitValue(*(long*)&value, iskey);
 	}
-	bool writeOpenData(const char *type, const size_t &count) {
+	bool openData(const char *type, const size_t &count) {
 		// NOTE: This breaks the current ubjson specs because we use H as a strong typed container,
 		// See: https://github.com/thebuzzmedia/universal-binary-json/issues/27
 		if (count < 255) {
@@ -126,32 +131,27 @@ protected:
 		}
 		return true;
 	}
-	template<class T> void writeData(const T * const &values, const size_t &count) {
+
+	template<class T> inline bool emitOpenData(const T * const &, const size_t &) { return false; }
+	inline bool emitOpenData(const float * const &, const size_t &count) { return openData("d", count); }
+	inline bool emitOpenData(const double * const &, const size_t &count) { return openData("D", count); }
+	inline bool emitOpenData(const short * const &, const size_t &count) { return openData("i", count); }
+	inline bool emitOpenData(const unsigned short * const &, const size_t &count) { return openData("i", count); }
+	inline bool emitOpenData(const int * const &, const size_t &count) { return openData("I", count); }
+	inline bool emitOpenData(const unsigned int * const &, const size_t &count) { return openData("I", count); }
+	inline bool emitOpenData(const long * const &, const size_t &count) { return openData("L", count); }
+	inline bool emitOpenData(const unsigned long * const &, const size_t &count) { return openData("L", count); }
+
+	template<class T> inline void emitData(const T * const &values, const size_t &count) {
 		for (size_t i = 0; i < count; i++)
 			write(values[i]);
 	}
-
-	inline virtual bool writeOpenFloatData(const size_t& count) { return writeOpenData("d", count); }
-	inline virtual bool writeOpenDoubleData(const size_t& count) { return writeOpenData("D", count); }
-	inline virtual bool writeOpenShortData(const size_t& count) { return writeOpenData("i", count); }
-	inline virtual bool writeOpenUShortData(const size_t& count) { return writeOpenData("i", count); }
-	inline virtual bool writeOpenIntData(const size_t& count) { return writeOpenData("I", count); }
-	inline virtual bool writeOpenUIntData(const size_t& count) { return writeOpenData("I", count); }
-	inline virtual bool writeOpenLongData(const size_t& count) { return writeOpenData("L", count); }
-	inline virtual bool writeOpenULongData(const size_t& count) { return writeOpenData("L", count); }
-
-	inline virtual void writeFloatData(const float * const &values, const size_t &count) { writeData(values, count); }
-	inline virtual void writeDoubleData(const double * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeShortData(const short * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeUShortData(const unsigned short * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeIntData(const int * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeUIntData(const unsigned int * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeLongData(const long * const &values, const size_t &count) {writeData(values, count); }
-	inline virtual void writeULongData(const unsigned long * const &values, const size_t &count) {writeData(values, count); }
-
-	virtual void writeCloseData() {}
 };
 
+inline void ConstSerializable::serialize(UBJSONWriter &writer) const {
+	serialize(static_cast<BaseJSONWriter &>(writer));
+}
+
 }
 
 #endif //JSON_UBJSONWRITER_H
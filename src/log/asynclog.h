@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_LOG_ASYNCLOG_H
+#define FBXCONV_LOG_ASYNCLOG_H
+
+#include <string.h>
+#include "log.h"
+#include "../util/thread.h"
+
+namespace fbxconv {
+namespace log {
+	/** Log which formats the messages on the calling thread into a lock-free ring buffer and writes them on a background thread.
+	 * Any thread can log concurrently. When the buffer is full, progress messages are dropped and other messages wait until
+	 * there's room. Messages which don't pass the filter aren't formatted at all. */
+	class AsyncLog : public Log, private util::Thread {
+	public:
+		/** The number of messages the buffer can hold, must be a power of two */
+		static const long CAPACITY		= 256;
+
+		AsyncLog(LogMessages * const &messages, const int &filter = -1) : Log(messages, filter), head(0), tail(0), stopped(0) {
+			slots = new Slot[CAPACITY];
+			for (long i = 0; i < CAPACITY; i++)
+				slots[i].sequence = i;
+			threaded = start();
+		}
+
+		virtual ~AsyncLog() {
+			util::atomicAdd(&stopped, 1);
+			join();
+			drain();
+			delete[] slots;
+		}
+
+		virtual void flush() {
+			if (threaded) {
+				const long pos = head;
+				while (tail - pos < 0)
+					util::yield();
+			}
+			Log::flush();
+		}
+
+		virtual void log(const int &type, const char *s) {
+			if (!isEnabled(type))
+				return;
+			if (!threaded) {
+				Log::log(type, s);
+				return;
+			}
+			const long pos = acquire(type == LOG_PROGRESS);
+			if (pos < 0)
+				return;
+			Slot &slot = slots[pos & (CAPACITY - 1)];
+			strncpy(slot.text, s, MAX_LENGTH - 1);
+			slot.text[MAX_LENGTH - 1] = 0;
+			publish(slot, type, pos);
+		}
+
+		virtual void vlog(const int &type, const int &code, va_list vl) {
+			if (!isEnabled(type))
+				return;
+			if (!threaded) {
+				Log::vlog(type, code, vl);
+				return;
+			}
+			const long pos = acquire(type == LOG_PROGRESS);
+			if (pos < 0)
+				return;
+			Slot &slot = slots[pos & (CAPACITY - 1)];
+			vformat(slot.text, code, vl);
+			publish(slot, type, pos);
+		}
+
+		virtual void vlog(const int &type, const char *m, va_list vl) {
+			if (!isEnabled(type))
+				return;
+			if (!threaded) {
+				Log::vlog(type, m, vl);
+				return;
+			}
+			const long pos = acquire(type == LOG_PROGRESS);
+			if (pos < 0)
+				return;
+			Slot &slot = slots[pos & (CAPACITY - 1)];
+			vformat(slot.text, m, vl);
+			publish(slot, type, pos);
+		}
+
+	protected:
+		virtual void run() {
+			while (stopped == 0)
+				if (!drain())
+					util::sleep(1);
+		}
+
+	private:
+		struct Slot {
+			/** Equals the position when the slot is free, the position + 1 when it contains a message */
+			volatile long sequence;
+			int type;
+			char text[MAX_LENGTH];
+		};
+
+		Slot *slots;
+		/** The position of the next slot to fill, shared by the producers */
+		volatile long head;
+		/** The position of the next slot to write, only changed by the background thread */
+		volatile long tail;
+		volatile long stopped;
+		bool threaded;
+
+		/** Reserve the next slot and return its position, or -1 if the buffer is full and the message may be dropped */
+		long acquire(const bool &mayDrop) {
+			long pos = head;
+			for (;;) {
+				const Slot &slot = slots[pos & (CAPACITY - 1)];
+				util::memoryBarrier();
+				const long diff = slot.sequence - pos;
+				if (diff == 0) {
+					if (util::atomicCompareAndSwap(&head, pos, pos + 1))
+						return pos;
+				}
+				else if (diff < 0) {
+					if (mayDrop)
+						return -1;
+					util::yield();
+				}
+				pos = head;
+			}
+		}
+
+		inline void publish(Slot &slot, const int &type, const long &pos) {
+			slot.type = type;
+			util::memoryBarrier();
+			slot.sequence = pos + 1;
+		}
+
+		/** Write all available messages, returns false if there were none */
+		bool drain() {
+			bool result = false;
+			for (;;) {
+				Slot &slot = slots[tail & (CAPACITY - 1)];
+				util::memoryBarrier();
+				if (slot.sequence != tail + 1)
+					break;
+				Log::log(slot.type, slot.text);
+				util::memoryBarrier();
+				slot.sequence = tail + CAPACITY;
+				tail = tail + 1;
+				result = true;
+			}
+			if (result)
+				fflush(stdout);
+			return result;
+		}
+	};
+
+	const long AsyncLog::CAPACITY;
+} }
+
+#endif //FBXCONV_LOG_ASYNCLOG_H
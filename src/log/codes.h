@@ -37,6 +37,16 @@ LOG_ADD_CODE(eCommandLineMissingInputFile)
 LOG_ADD_CODE(eCommandLineInvalidVertexWeight)
 LOG_ADD_CODE(eCommandLineInvalidBoneCount)
 LOG_ADD_CODE(eCommandLineInvalidVertexCount)
+LOG_ADD_CODE(eCommandLineInvalidWeldTolerance)
+LOG_ADD_CODE(eCommandLineInvalidLodRatio)
+LOG_ADD_CODE(eCommandLineInvalidAtlasSize)
+LOG_ADD_CODE(eCommandLineInvalidTextureSize)
+LOG_ADD_CODE(eCommandLineInvalidThreadCount)
+LOG_ADD_CODE(eCommandLineInvalidLogFile)
+LOG_ADD_CODE(eCommandLineStreamingFiletype)
+LOG_ADD_CODE(eCommandLineInvalidAnimationTolerance)
+LOG_ADD_CODE(eCommandLineInvalidClipFile)
+LOG_ADD_CODE(eCommandLineBlendShapesFiletype)
 LOG_ADD_CODE(eCommandLineUnknownFiletype)
 
 LOG_ADD_CODE(sSourceLoad)
@@ -45,6 +55,12 @@ LOG_ADD_CODE(wSourceLoadFbxNodeRrSs)
 LOG_ADD_CODE(eSourceLoadGeneral)
 LOG_ADD_CODE(eSourceLoadFiletypeUnknown)
 LOG_ADD_CODE(eSourceLoadFbxSdk)
+LOG_ADD_CODE(eSourceLoadFbxNoSdk)
+LOG_ADD_CODE(iSourceLoadDuplicateTextures)
+LOG_ADD_CODE(eSourceLoadObjFile)
+LOG_ADD_CODE(wSourceLoadObjLibrary)
+LOG_ADD_CODE(wSourceLoadObjInvalidFaces)
+LOG_ADD_CODE(iSourceLoadObj)
 
 LOG_ADD_CODE(sSourceConvert)
 LOG_ADD_CODE(sSourceConvertFbxTriangulate)
@@ -63,6 +79,17 @@ LOG_ADD_CODE(wSourceConvertFbxMaterialUnknown)
 LOG_ADD_CODE(wSourceConvertFbxMaterialHLSL)
 LOG_ADD_CODE(wSourceConvertFbxMaterialCgFX)
 LOG_ADD_CODE(wSourceConvertFbxSkipPropname)
+LOG_ADD_CODE(wSourceConvertFbxUnusedClip)
+LOG_ADD_CODE(wSourceConvertFbxInBetweenShapes)
+LOG_ADD_CODE(iSourceConvertLod)
+LOG_ADD_CODE(iSourceConvertStaticBatch)
+LOG_ADD_CODE(iSourceConvertMergedMaterials)
+LOG_ADD_CODE(wSourceConvertObjNoMaterial)
+LOG_ADD_CODE(wTextureLoad)
+LOG_ADD_CODE(wTextureSave)
+LOG_ADD_CODE(iTextureAtlas)
+LOG_ADD_CODE(wTextureFormat)
+LOG_ADD_CODE(iTextureProcessed)
 LOG_ADD_CODE(eSourceConvert)
 
 LOG_ADD_CODE(sSourceClose)
@@ -70,6 +97,7 @@ LOG_ADD_CODE(eSourceClose)
 
 LOG_ADD_CODE(sExportToG3DB)
 LOG_ADD_CODE(sExportToG3DJ)
+LOG_ADD_CODE(sExportToG3DM)
 LOG_ADD_CODE(sExportClose)
 LOG_ADD_CODE(eExportFiletypeUnknown)
 
@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_LOG_JSONLOG_H
+#define FBXCONV_LOG_JSONLOG_H
+
+#include <string>
+#include <stdio.h>
+#include "log.h"
+#include "../util/thread.h"
+#include "../util/timer.h"
+
+namespace fbxconv {
+namespace log {
+	/** Log which writes each message as a single line JSON object to a file, for example:
+	 * {"time":0.125304,"level":"warning","code":"wSourceConvertFbxExceedsBones","text":"...","file":"model.fbx"}
+	 * The time is the number of seconds since the log was created, the code is null for messages without a code.
+	 * Messages are also passed on to the next log (if any), which applies its own filter. This class is thread safe
+	 * if the next log is. */
+	class JSONLog : public Log {
+	public:
+		/** The input file the messages relate to */
+		std::string inputFile;
+
+		/** The file must be open for writing and is not closed by this log */
+		JSONLog(LogMessages * const &messages, FILE * const &file, Log * const &next = 0, const int &filter = -1)
+			: Log(messages, filter), file(file), next(next) {}
+
+		virtual void flush() {
+			if (next)
+				next->flush();
+			util::ScopedLock lock(mutex);
+			fflush(file);
+		}
+
+		virtual void log(const int &type, const char *s) {
+			write(type, -1, s);
+		}
+
+		virtual void vlog(const int &type, const int &code, va_list vl) {
+			if (!isEnabled(type) && !(next && next->isEnabled(type)))
+				return;
+			char buff[MAX_LENGTH];
+			write(type, code, vformat(buff, code, vl));
+		}
+
+		virtual void vlog(const int &type, const char *m, va_list vl) {
+			if (!isEnabled(type) && !(next && next->isEnabled(type)))
+				return;
+			char buff[MAX_LENGTH];
+			write(type, -1, vformat(buff, m, vl));
+		}
+
+	private:
+		FILE *file;
+		Log *next;
+		util::Mutex mutex;
+		util::Timer timer;
+
+		void write(const int &type, const int &code, const char *s) {
+			if (next)
+				next->log(type, s);
+			if (!isEnabled(type))
+				return;
+			std::string line;
+			line.reserve(256);
+			char buff[64];
+			sprintf(buff, "{\"time\":%.6f,\"level\":\"", timer.elapsed());
+			line += buff;
+			line += levelName(type);
+			line += "\",\"code\":";
+			const char *name = code >= 0 ? codeName(code) : 0;
+			if (name) {
+				line += '"';
+				line += name;
+				line += '"';
+			}
+			else
+				line += "null";
+			line += ",\"text\":";
+			appendString(line, s);
+			line += ",\"file\":";
+			appendString(line, inputFile.c_str());
+			line += "}\n";
+			util::ScopedLock lock(mutex);
+			fwrite(line.c_str(), 1, line.length(), file);
+		}
+
+		static const char *levelName(const int &type) {
+			switch(type) {
+			case LOG_STATUS:	return "status";
+			case LOG_PROGRESS:	return "progress";
+			case LOG_DEBUG:		return "debug";
+			case LOG_INFO:		return "info";
+			case LOG_VERBOSE:	return "verbose";
+			case LOG_WARNING:	return "warning";
+			case LOG_ERROR:		return "error";
+			default:			return "unknown";
+			}
+		}
+
+		/** Append the value as a quoted and escaped JSON string */
+		static void appendString(std::string &line, const char *value) {
+			static const char hex[] = "0123456789abcdef";
+			line += '"';
+			for (const unsigned char *c = (const unsigned char *)value; *c; c++) {
+				switch(*c) {
+				case '"':	line += "\\\""; break;
+				case '\\':	line += "\\\\"; break;
+				case '\n':	line += "\\n"; break;
+				case '\r':	line += "\\r"; break;
+				case '\t':	line += "\\t"; break;
+				default:
+					if (*c < 0x20) {
+						line += "\\u00";
+						line += hex[*c >> 4];
+						line += hex[*c & 0xF];
+					}
+					else
+						line += (char)*c;
+				}
+			}
+			line += '"';
+		}
+	};
+} }
+
+#endif //FBXCONV_LOG_JSONLOG_H
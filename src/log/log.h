@@ -32,7 +32,9 @@ namespace fbxconv {
 namespace log {
 
 	struct LogMessages : std::vector<const char*> {
-		LogMessages() { resize(num_codes); }
+		/** The name of each code, as used in codes.h */
+		std::vector<const char*> names;
+		LogMessages() : names(num_codes, (const char*)0) { resize(num_codes); }
 		virtual ~LogMessages() {}
 	};
 
@@ -46,10 +48,13 @@ namespace log {
 		static const int LOG_WARNING	= 0x1 << 5;
 		static const int LOG_ERROR		= 0x1 << 6;
 
+		/** The maximum length of a formatted message, including the terminating zero */
+		static const int MAX_LENGTH		= 1024;
+
 		int filter;
 		LogMessages * messages;
 
-		Log(LogMessages * const &messages, const int &filter = -1) : messages(messages), filter(filter) {}
+		Log(LogMessages * const &messages, const int &filter = -1) : messages(messages), filter(filter), inProgress(false) {}
 
 		virtual ~Log() {
 			delete messages;
@@ -59,18 +64,44 @@ namespace log {
 			return (*messages)[code];
 		}
 
-		const char *vformat(int code, va_list vl) {
-			static char buff[1024];
-			vsnprintf(buff, 1024, msg(code), vl);
+		/** The name of the code, e.g. "wSourceConvertFbxExceedsBones", or null if the code has no message */
+		const char *codeName(int code) {
+			return messages->names[code];
+		}
+
+		/** Whether messages of the type pass the filter, use this to avoid the cost of creating the arguments */
+		inline bool isEnabled(const int &type) const {
+			return (filter & type) != 0;
+		}
+
+		/** Wait until all previously logged messages are written, call this before writing directly to the console */
+		virtual void flush() {
+			fflush(stdout);
+		}
+
+		/** Format the message into the buffer, which must be (at least) MAX_LENGTH long. This method is thread safe. */
+		const char *vformat(char * const &buff, int code, va_list vl) {
+			vsnprintf(buff, MAX_LENGTH, msg(code), vl);
+			buff[MAX_LENGTH - 1] = 0;
 			return buff;
 		}
 
-		const char *vformat(const char *m, va_list vl) {
-			static char buff[1024];
-			vsnprintf(buff, 1024, m, vl);
+		const char *vformat(char * const &buff, const char *m, va_list vl) {
+			vsnprintf(buff, MAX_LENGTH, m, vl);
+			buff[MAX_LENGTH - 1] = 0;
 			return buff;
 		}
 
+		const char *vformat(int code, va_list vl) {
+			static char buff[MAX_LENGTH];
+			return vformat(buff, code, vl);
+		}
+
+		const char *vformat(const char *m, va_list vl) {
+			static char buff[MAX_LENGTH];
+			return vformat(buff, m, vl);
+		}
+
 		const char *format(int code, ...) {
 			va_list vl;
 			va_start(vl, code);
@@ -88,9 +119,8 @@ namespace log {
 		}
 
 		virtual void log(const int &type, const char *s) {
-			static bool inProgress = false;
 			assert(!((type == 0) || (type & (type - 1))));
-			if (((filter & type) == 0))
+			if (!isEnabled(type))
 				return;
 			if (type  == LOG_PROGRESS) {
 				inProgress = true;
@@ -113,11 +143,17 @@ namespace log {
 		}
 
 		virtual void vlog(const int &type, const int &code, va_list vl) {
-			log(type, vformat(code, vl));
+			if (!isEnabled(type))
+				return;
+			char buff[MAX_LENGTH];
+			log(type, vformat(buff, code, vl));
 		}
 
 		virtual void vlog(const int &type, const char *m, va_list vl) {
-			log(type, vformat(m, vl));
+			if (!isEnabled(type))
+				return;
+			char buff[MAX_LENGTH];
+			log(type, vformat(buff, m, vl));
 		}
 
 		virtual void log(const int &type, const int &code, ...) {
@@ -179,6 +215,9 @@ namespace log {
 		virtual void error(int code, ...) {
 			va_list vl; va_start(vl, code); vlog(LOG_ERROR, code, vl); va_end(vl);
 		}
+	private:
+		/** Whether the last line written is a progress line, which is overwritten by the next line */
+		bool inProgress;
 	};
 
 	const int Log::LOG_STATUS;
@@ -188,12 +227,13 @@ namespace log {
 	const int Log::LOG_INFO;
 	const int Log::LOG_WARNING;
 	const int Log::LOG_ERROR;
+	const int Log::MAX_LENGTH;
 } }
 
 #define LOG_START_MESSAGES(clazz) \
 	struct clazz : LogMessages { \
 		clazz() {
-#define LOG_SET_MSG(code, msg) (*this)[code] = msg;
+#define LOG_SET_MSG(code, msg) (*this)[code] = msg; names[code] = #code;
 #define LOG_END_MESSAGES() \
 		} \
 	};
@@ -38,6 +38,16 @@ LOG_SET_MSG(eCommandLineMissingInputFile,		"Missing input file")
 LOG_SET_MSG(eCommandLineInvalidVertexWeight,	"Maximum vertex weights must be between 0 and 8")
 LOG_SET_MSG(eCommandLineInvalidBoneCount,		"Maximum bones per nodepart must be greater or equal to the maximum vertex weights")
 LOG_SET_MSG(eCommandLineInvalidVertexCount,		"Maximum vertex count must be between 0 and 32k")
+LOG_SET_MSG(eCommandLineInvalidWeldTolerance,	"Weld tolerances must be positive and the normal angle at most 180 degrees")
+LOG_SET_MSG(eCommandLineInvalidLodRatio,		"Level of detail ratios must be between 0 and 1")
+LOG_SET_MSG(eCommandLineInvalidAtlasSize,		"Atlas size must be a power of two of at least 64")
+LOG_SET_MSG(eCommandLineInvalidTextureSize,		"Texture size cannot be negative")
+LOG_SET_MSG(eCommandLineInvalidThreadCount,		"Thread count cannot be negative")
+LOG_SET_MSG(eCommandLineInvalidLogFile,			"Unable to open log file '%s'")
+LOG_SET_MSG(eCommandLineStreamingFiletype,		"Streaming is only supported for G3DJ and G3DB files")
+LOG_SET_MSG(eCommandLineInvalidAnimationTolerance,	"Animation tolerance must be greater than zero")
+LOG_SET_MSG(eCommandLineInvalidClipFile,		"Unable to read clip file '%s', each line must be: name start end [take]")
+LOG_SET_MSG(eCommandLineBlendShapesFiletype,	"Blend shapes are only supported for G3DJ and G3DB files")
 LOG_SET_MSG(eCommandLineUnknownFiletype,		"Unknown filetype: %s")
 
 LOG_SET_MSG(sSourceLoad,						"Loading source file")
@@ -46,6 +56,12 @@ LOG_SET_MSG(wSourceLoadFbxNodeRrSs,				"[%s] Node uses RrSs mode, transformation
 LOG_SET_MSG(eSourceLoadGeneral,					"Error loading source file: %s")
 LOG_SET_MSG(eSourceLoadFiletypeUnknown,			"Unknown source filetype")
 LOG_SET_MSG(eSourceLoadFbxSdk,					"FBX SDK encountered an error: %s")
+LOG_SET_MSG(eSourceLoadFbxNoSdk,				"Built without the FBX SDK, only OBJ files can be converted")
+LOG_SET_MSG(iSourceLoadDuplicateTextures,		"Merged %d duplicate textures, saving %.1f KB")
+LOG_SET_MSG(eSourceLoadObjFile,					"Unable to open OBJ file '%s'")
+LOG_SET_MSG(wSourceLoadObjLibrary,				"Unable to load material library '%s'")
+LOG_SET_MSG(wSourceLoadObjInvalidFaces,			"Skipped %d faces with invalid vertex indices")
+LOG_SET_MSG(iSourceLoadObj,						"Parsed %d positions into %d groups (%d chunks on %d threads)")
 
 LOG_SET_MSG(sSourceConvert,						"Converting source file")
 LOG_SET_MSG(sSourceConvertFbxTriangulate,		"[%s] Triangulating %s geometry")
@@ -64,6 +80,17 @@ LOG_SET_MSG(wSourceConvertFbxMaterialUnknown,	"[%s] Material doesn\'t extend Fbx
 LOG_SET_MSG(wSourceConvertFbxMaterialHLSL,		"[%s] Material HLSL shading not supported, replaced with RED diffuse")
 LOG_SET_MSG(wSourceConvertFbxMaterialCgFX,		"[%s] Material CgFX shading not supported, replaced with RED diffuse")
 LOG_SET_MSG(wSourceConvertFbxSkipPropname,		"[%s] Skipping propName '%s'")
+LOG_SET_MSG(wSourceConvertFbxInBetweenShapes,	"[%s] Blend shape '%s' has in-between shapes, only the shape at full weight is used")
+LOG_SET_MSG(wSourceConvertFbxUnusedClip,		"Clip '%s' doesn't match an animation stack (take '%s')")
+LOG_SET_MSG(iSourceConvertLod,					"[%s] Level of detail %d: %d of %d triangles")
+LOG_SET_MSG(iSourceConvertStaticBatch,			"Baked %d static nodes into %d meshparts")
+LOG_SET_MSG(iSourceConvertMergedMaterials,		"Merged %d equal materials, %d materials left")
+LOG_SET_MSG(wSourceConvertObjNoMaterial,		"Material '%s' not found, using the default material")
+LOG_SET_MSG(wTextureLoad,						"Unable to load texture '%s'")
+LOG_SET_MSG(wTextureSave,						"Unable to save texture '%s'")
+LOG_SET_MSG(iTextureAtlas,						"Packed %d textures into %d atlas pages")
+LOG_SET_MSG(wTextureFormat,						"Unable to process texture '%s', only PNG is supported")
+LOG_SET_MSG(iTextureProcessed,					"Processed %d textures using %d threads")
 LOG_SET_MSG(eSourceConvert,						"Error converting source file")
 
 LOG_SET_MSG(sSourceClose,						"Closing source file")
@@ -71,6 +98,7 @@ LOG_SET_MSG(eSourceClose,						"Error closing source file")
 
 LOG_SET_MSG(sExportToG3DB,						"Exporting to G3DB file: %s")
 LOG_SET_MSG(sExportToG3DJ,						"Exporting to G3DJ file: %s")
+LOG_SET_MSG(sExportToG3DM,						"Exporting to G3DM file: %s")
 LOG_SET_MSG(sExportClose,						"Closing exported file")
 LOG_SET_MSG(eExportFiletypeUnknown,				"Unknown target filetype")
 
@@ -22,10 +22,8 @@
 
 #include "FbxConv.h"
 
-#include <fbxsdk.h>
 #include "Settings.h"
 #include "FbxConvCommand.h"
-#include "readers/FbxConverter.h"
 #include "json/JSONWriter.h"
 #include "json/UBJSONWriter.h"
 #include <string>
@@ -33,6 +31,7 @@
 #include <fstream>
 
 #include "log/messages.h"
+#include "log/asynclog.h"
 
 using namespace fbxconv;
 using namespace fbxconv::modeldata;
@@ -41,7 +40,7 @@ using namespace fbxconv::readers;
 
 
 int process(int argc, const char** argv) {
-	log::Log log(new log::DefaultMessages(), -1);
+	log::AsyncLog log(new log::DefaultMessages(), -1);
 	FbxConv conv(&log);
 	return conv.execute(argc, argv) ? 0 : 1;
 }
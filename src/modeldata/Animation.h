@@ -23,6 +23,7 @@
 #include <vector>
 #include "Node.h"
 #include "NodeAnimation.h"
+#include "BlendShape.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
@@ -32,22 +33,40 @@ namespace modeldata {
 	struct Animation : public json::ConstSerializable {
 		std::string id;
 		std::vector<NodeAnimation *> nodeAnimations;
+		/** The weights of the blend shapes over time */
+		std::vector<BlendShapeAnimation *> blendShapeAnimations;
+		/** The keytimes (in milliseconds) shared by all node animations (a unified timeline), or empty if each node animation has its own */
+		std::vector<float> keytimes;
+		/** The time (in milliseconds) between two frames the keyframes are sampled at, or 0 if unknown */
+		float frameTime;
+		/** The maximum error of the quantized keytimes, or 0 to write the keytimes unquantized */
+		float tolerance;
 
-		Animation() {}
+		Animation() : frameTime(0.f), tolerance(0.f) {}
 
 		Animation(const Animation &copyFrom) {
 			id = copyFrom.id;
+			keytimes = copyFrom.keytimes;
+			frameTime = copyFrom.frameTime;
+			tolerance = copyFrom.tolerance;
 			for (std::vector<NodeAnimation *>::const_iterator itr = copyFrom.nodeAnimations.begin(); itr != copyFrom.nodeAnimations.end(); ++itr)
 				nodeAnimations.push_back(new NodeAnimation(*(*itr)));
+			for (std::vector<BlendShapeAnimation *>::const_iterator itr = copyFrom.blendShapeAnimations.begin(); itr != copyFrom.blendShapeAnimations.end(); ++itr)
+				blendShapeAnimations.push_back(new BlendShapeAnimation(*(*itr)));
 		}
 
 		~Animation() {
 			for (std::vector<NodeAnimation *>::iterator itr = nodeAnimations.begin(); itr != nodeAnimations.end(); ++itr)
 				if ((*itr)!=0)
 					delete *itr;
+			for (std::vector<BlendShapeAnimation *>::iterator itr = blendShapeAnimations.begin(); itr != blendShapeAnimations.end(); ++itr)
+				delete *itr;
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 } }
 
@@ -97,7 +97,38 @@ namespace modeldata {
 		INIT_VECTOR(unsigned short, AttributeTypeBlend)	// Blendweight7
 	};
 
-	#define ATTRIBUTE_SIZE(idx) (AttributeTypes[idx].size())
+	/** The number of values (floats) of each attribute */
+	static const unsigned int AttributeSizes[ATTRIBUTE_COUNT] = {4, 3, 3, 4, 1, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+
+	#define ATTRIBUTE_SIZE(idx) (AttributeSizes[idx])
+
+	/** The bits of all attributes */
+	#define ATTRIBUTE_MASK_ALL		((1UL << ATTRIBUTE_COUNT) - 1)
+	/** The bits of the attributes per number of values, so the size of a combination of attributes can be calculated
+	 * without checking each attribute */
+	#define ATTRIBUTE_MASK_SIZE1	(1UL << ATTRIBUTE_COLORPACKED)
+	#define ATTRIBUTE_MASK_SIZE2	(0xFFFFUL << ATTRIBUTE_TEXCOORD0)
+	#define ATTRIBUTE_MASK_SIZE3	((1UL << ATTRIBUTE_POSITION) | (1UL << ATTRIBUTE_NORMAL) | (1UL << ATTRIBUTE_TANGENT) | (1UL << ATTRIBUTE_BINORMAL))
+	#define ATTRIBUTE_MASK_SIZE4	((1UL << ATTRIBUTE_UNKNOWN) | (1UL << ATTRIBUTE_COLOR))
+
+	/** The number of bits set within the lower 32 bits of the value */
+	inline unsigned int bitCount(const unsigned long &value) {
+		unsigned int v = (unsigned int)(value & 0xFFFFFFFFUL);
+		v = v - ((v >> 1) & 0x55555555U);
+		v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+		return (((v + (v >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+	}
+
+	/** The index of the lowest bit set within the value, which must not be zero */
+	inline unsigned int lowestBit(const unsigned long &value) {
+		return bitCount((value & (~value + 1)) - 1);
+	}
+
+	/** The number of values (floats) of the combination of attributes specified by the bit mask */
+	inline unsigned int attributesSize(const unsigned long &mask) {
+		return bitCount(mask & ATTRIBUTE_MASK_SIZE1) + 2 * bitCount(mask & ATTRIBUTE_MASK_SIZE2) +
+			3 * bitCount(mask & ATTRIBUTE_MASK_SIZE3) + 4 * bitCount(mask & ATTRIBUTE_MASK_SIZE4);
+	}
 
 	struct Attributes : public json::ConstSerializable {
 		unsigned long value;
@@ -112,27 +143,19 @@ namespace modeldata {
 			return value == rhs.value;
 		}
 
-		unsigned int size() const {
-			unsigned int result = 0;
-			for (unsigned int i = 0; i < ATTRIBUTE_COUNT; i++)
-				if (has(i))
-					result += (unsigned int)ATTRIBUTE_SIZE(i);
-			return result;
+		inline unsigned int size() const {
+			return attributesSize(value);
 		}
 
-		unsigned int length() const {
-			unsigned int result = 0;
-			for (unsigned int i = 0; i < ATTRIBUTE_COUNT; i++)
-				if (has(i))
-					result++;
-			return result;
+		inline unsigned int length() const {
+			return bitCount(value & ATTRIBUTE_MASK_ALL);
 		}
 
 		/** 0 <= index < length() */
 		const int get(unsigned int index) const {
-			for (unsigned int i = 0; i < ATTRIBUTE_COUNT; i++)
-				if (has(i) && index-- <= 0)
-					return i;
+			for (unsigned long bits = value & ATTRIBUTE_MASK_ALL; bits != 0; bits &= bits - 1)
+				if (index-- <= 0)
+					return (int)lowestBit(bits);
 			return -1;
 		}
 
@@ -145,10 +168,10 @@ namespace modeldata {
 		/** 0 <= v < size() */
 		const unsigned short getType(const unsigned int &v) const {
 			unsigned int s = 0;
-			for (unsigned int i = 0; i < ATTRIBUTE_COUNT; i++) {
-				if (!has(i))
-					continue;
-				const unsigned short is = (unsigned short)ATTRIBUTE_SIZE(i);
+			// Only visit the attributes which are set
+			for (unsigned long bits = value & ATTRIBUTE_MASK_ALL; bits != 0; bits &= bits - 1) {
+				const unsigned int i = lowestBit(bits);
+				const unsigned int is = ATTRIBUTE_SIZE(i);
 				if ((s + is) > v)
 					return AttributeTypes[i][v-s];
 				s+=is;
@@ -156,6 +179,11 @@ namespace modeldata {
 			return 0;
 		}
 
+		/** The offset (in floats) of the attribute within a vertex, or -1 if not available */
+		inline int getOffset(const unsigned int &attribute) const {
+			return has(attribute) ? (int)attributesSize(value & ((1UL << attribute) - 1)) : -1;
+		}
+
 		void set(const unsigned int &attribute, const bool &v) {
 			if (v)
 				add(attribute);
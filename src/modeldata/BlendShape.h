@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELDATA_BLENDSHAPE_H
+#define FBXCONV_MODELDATA_BLENDSHAPE_H
+
+#include <vector>
+#include <string>
+#include "../json/BaseJSONWriter.h"
+
+namespace fbxconv {
+namespace modeldata {
+	/** A blend shape (morph target) of a mesh, stored sparse: only the vertices the shape changes are listed, along with the
+	 * difference between the shape and the mesh at full weight. */
+	struct BlendShape : public json::ConstSerializable {
+		std::string id;
+		/** The index (within the mesh) of each vertex changed by the shape */
+		std::vector<unsigned short> indices;
+		/** The position difference (x, y, z) of each changed vertex */
+		std::vector<float> positions;
+		/** The normal difference (x, y, z) of each changed vertex, empty if the mesh or the shape has no normals */
+		std::vector<float> normals;
+
+		/** Release the differences (e.g. after they're written) */
+		void releaseData() {
+			std::vector<unsigned short>().swap(indices);
+			std::vector<float>().swap(positions);
+			std::vector<float>().swap(normals);
+		}
+
+		virtual void serialize(json::BaseJSONWriter &writer) const;
+	};
+
+	/** The weight (0 to 1) of a blend shape over time */
+	struct BlendShapeAnimation : public json::ConstSerializable {
+		const BlendShape *shape;
+		/** The time (in milliseconds) of each keyframe */
+		std::vector<float> keytimes;
+		/** The weight of the shape at each keyframe */
+		std::vector<float> weights;
+
+		BlendShapeAnimation() : shape(0) {}
+
+		virtual void serialize(json::BaseJSONWriter &writer) const;
+	};
+} }
+
+#endif //FBXCONV_MODELDATA_BLENDSHAPE_H
@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif
+#ifndef MODELDATA_BOUNDS_H
+#define MODELDATA_BOUNDS_H
+
+#include <float.h>
+#include <math.h>
+#include "../json/BaseJSONWriter.h"
+
+namespace fbxconv {
+namespace modeldata {
+	/** An axis aligned bounding box combined with a bounding sphere */
+	struct Bounds : public json::ConstSerializable {
+		float min[3];
+		float max[3];
+		float center[3];
+		float radius;
+
+		Bounds() {
+			clear();
+		}
+
+		Bounds(const Bounds &copyFrom) {
+			set(copyFrom);
+		}
+
+		Bounds &operator=(const Bounds &rhs) {
+			set(rhs);
+			return *this;
+		}
+
+		void clear() {
+			min[0] = min[1] = min[2] = FLT_MAX;
+			max[0] = max[1] = max[2] = -FLT_MAX;
+			center[0] = center[1] = center[2] = 0.f;
+			radius = -1.f;
+		}
+
+		void set(const Bounds &other) {
+			for (int i = 0; i < 3; i++) {
+				min[i] = other.min[i];
+				max[i] = other.max[i];
+				center[i] = other.center[i];
+			}
+			radius = other.radius;
+		}
+
+		inline bool isValid() const {
+			return min[0] <= max[0] && min[1] <= max[1] && min[2] <= max[2];
+		}
+
+		/** Extend the box to contain the point, call calcSphere or extSphere to update the sphere. */
+		inline void ext(const float * const &point) {
+			for (int i = 0; i < 3; i++) {
+				if (point[i] < min[i])
+					min[i] = point[i];
+				if (point[i] > max[i])
+					max[i] = point[i];
+			}
+		}
+
+		/** Initialize the sphere at the center of the box with a zero radius, use extSphere to add the points. */
+		void calcSphere() {
+			for (int i = 0; i < 3; i++)
+				center[i] = (min[i] + max[i]) * 0.5f;
+			radius = 0.f;
+		}
+
+		/** Extend the sphere (without moving its center) to contain the point */
+		inline void extSphere(const float * const &point) {
+			const float dx = point[0] - center[0], dy = point[1] - center[1], dz = point[2] - center[2];
+			const float d2 = dx * dx + dy * dy + dz * dz;
+			if (d2 > radius * radius)
+				radius = sqrt(d2);
+		}
+
+		/** Extend both the box and the sphere to contain the other bounds */
+		void ext(const Bounds &other) {
+			if (!other.isValid())
+				return;
+			if (!isValid()) {
+				set(other);
+				return;
+			}
+			ext(other.min);
+			ext(other.max);
+			extSphere(other.center, other.radius);
+		}
+
+		/** Extend both the box and the sphere to contain the other bounds after applying the transformation to it,
+		 * the rotation is a quaternion (x, y, z, w). */
+		void ext(const Bounds &other, const float * const &translation, const float * const &rotation, const float * const &scale) {
+			if (!other.isValid())
+				return;
+			Bounds b;
+			float p[3];
+			for (int i = 0; i < 8; i++) {
+				p[0] = (i & 1) ? other.max[0] : other.min[0];
+				p[1] = (i & 2) ? other.max[1] : other.min[1];
+				p[2] = (i & 4) ? other.max[2] : other.min[2];
+				transform(p, translation, rotation, scale);
+				b.ext(p);
+			}
+			for (int i = 0; i < 3; i++)
+				b.center[i] = other.center[i];
+			transform(b.center, translation, rotation, scale);
+			float s = fabs(scale[0]);
+			if (fabs(scale[1]) > s) s = fabs(scale[1]);
+			if (fabs(scale[2]) > s) s = fabs(scale[2]);
+			b.radius = other.radius * s;
+			ext(b);
+		}
+
+		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
+
+	private:
+		/** Grow the sphere to contain the other sphere, moving its center if needed */
+		void extSphere(const float * const &c, const float &r) {
+			const float d[3] = { c[0] - center[0], c[1] - center[1], c[2] - center[2] };
+			const float dist = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+			if (dist + r <= radius)
+				return;
+			if (dist + radius <= r) {
+				for (int i = 0; i < 3; i++)
+					center[i] = c[i];
+				radius = r;
+				return;
+			}
+			const float newRadius = (dist + radius + r) * 0.5f;
+			const float t = (newRadius - radius) / dist;
+			for (int i = 0; i < 3; i++)
+				center[i] += d[i] * t;
+			radius = newRadius;
+		}
+
+		static void transform(float * const &p, const float * const &translation, const float * const &q, const float * const &scale) {
+			const float v[3] = { p[0] * scale[0], p[1] * scale[1], p[2] * scale[2] };
+			// t = 2 * cross(q.xyz, v), v' = v + q.w * t + cross(q.xyz, t)
+			const float t[3] = { 2.f * (q[1] * v[2] - q[2] * v[1]), 2.f * (q[2] * v[0] - q[0] * v[2]), 2.f * (q[0] * v[1] - q[1] * v[0]) };
+			p[0] = v[0] + q[3] * t[0] + (q[1] * t[2] - q[2] * t[1]) + translation[0];
+			p[1] = v[1] + q[3] * t[1] + (q[2] * t[0] - q[0] * t[2]) + translation[1];
+			p[2] = v[2] + q[3] * t[2] + (q[0] * t[1] - q[1] * t[0]) + translation[2];
+		}
+	};
+}
+}
+
+#endif //MODELDATA_BOUNDS_H
@@ -0,0 +1,402 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELDATA_G3DMWRITER_H
+#define FBXCONV_MODELDATA_G3DMWRITER_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <string.h>
+#include "Model.h"
+
+namespace fbxconv {
+namespace modeldata {
+	const unsigned int G3DM_FORMAT_VERSION = 1;
+	/** The alignment of the sections and the buffers in the file */
+	const unsigned int G3DM_ALIGNMENT = 16;
+	const unsigned int G3DM_HEADER_SIZE = 32;
+	const unsigned int G3DM_SECTION_ENTRY_SIZE = 24;
+	/** The index used for a missing reference */
+	const unsigned int G3DM_NONE = 0xFFFFFFFF;
+
+	/** Writes the model in the G3DM format, which is meant to be memory mapped and used without parsing. All values are
+	 * little endian 32 bit unsigned integers or floats, unless noted otherwise. The file starts with a 32 byte header:
+	 *   char magic[4] ("G3DM"), u16 versionHi, u16 versionLo (of the model), u32 formatVersion, u32 headerSize,
+	 *   u32 sectionCount, u32 sectionTableOffset, u32 flags (0), u32 reserved (0)
+	 * followed by the section table, one 24 byte entry per section:
+	 *   u32 type (fourcc), u32 count (number of records), u64 offset (from the start of the file), u64 size (in bytes)
+	 * Every section starts at a multiple of 16 bytes. Strings are referenced by their offset in the STRS section, which
+	 * contains zero terminated UTF-8 strings (offset 0 is the empty string). Records are referenced by their index within
+	 * their section, a range of records by the index of the first record and the number of records. The sections are:
+	 *   STRS  the string table
+	 *   MESH  u32 attributes (bit mask of the ATTRIBUTE_ values), u32 vertexSize (in floats), u32 vertexCount,
+	 *         u32 firstPart, u32 partCount, u32 reserved, u64 vertexOffset (in DATA)
+	 *   PART  u32 id, u32 primitiveType, u32 indexCount, u32 mesh, u64 indexOffset (in DATA), u32 firstLod, u32 lodCount,
+	 *         float bounds[10] (min, max, center, radius; radius is negative if the bounds are invalid)
+	 *   PLOD  u32 part, the levels of detail referenced by the parts
+	 *   MATL  u32 id, u32 flags (bit 0 ambient, 1 diffuse, 2 emissive, 3 specular, 4 shininess, 5 opacity are valid),
+	 *         float ambient[3], diffuse[3], emissive[3], specular[3], shininess, opacity, u32 firstTexture, u32 textureCount
+	 *   TEXR  u32 id, u32 path, u32 usage, float uvTranslation[2], uvScale[2], u32 reserved
+	 *   NODE  u32 id, u32 parent (0xFFFFFFFF for the root nodes), u32 childCount, u32 firstNodePart, u32 nodePartCount,
+	 *         u32 reserved, float translation[3], rotation[4], scale[3], bounds[10]; parents precede their children
+	 *   NPRT  u32 part, u32 material, u32 firstBone, u32 boneCount, u32 firstUVMapping, u32 uvMappingCount
+	 *   BONE  u32 node, float translation[3], rotation[4], scale[3], u32 reserved
+	 *   UVMP  u32 firstIndex, u32 indexCount, the textures mapped to a uv channel, one record per uv channel
+	 *   UVIX  u32 texture, the indices (within the material) of the textures referenced by the uv mappings
+	 *   ANIM  u32 id, u32 firstNodeAnimation, u32 nodeAnimationCount, u32 flags (bit 0 all node animations share the same
+	 *         keyframe times)
+	 *   NANM  u32 node, u32 firstKeyframe, u32 keyframeCount, u32 flags (bit 0 translation, 1 rotation, 2 scale)
+	 *   KEYS  float time, translation[3], rotation[4], scale[3], u32 flags (bit 0 translation, 1 rotation, 2 scale)
+	 *   DATA  the vertex buffers (interleaved floats, in the order of the attribute bits) and index buffers (u16),
+	 *         each starting at a multiple of 16 bytes, so they can be uploaded to the GPU directly */
+	class G3DMWriter {
+	public:
+		G3DMWriter(std::ostream &stream) : stream(stream) {}
+
+		void write(const Model * const &model) {
+			clear();
+			addString("");
+			Section &meshes = add("MESH"), &parts = add("PART"), &lods = add("PLOD");
+			Section &materials = add("MATL"), &textures = add("TEXR");
+			Section &nodes = add("NODE"), &nodeParts = add("NPRT"), &bones = add("BONE"), &uvMappings = add("UVMP");
+			Section &uvIndices = add("UVIX");
+			Section &animations = add("ANIM"), &nodeAnimations = add("NANM"), &keyframes = add("KEYS");
+
+			unsigned long long dataSize = 0;
+			std::map<const MeshPart *, unsigned int> partIndices;
+			for (std::vector<Mesh *>::const_iterator itr = model->meshes.begin(); itr != model->meshes.end(); ++itr)
+				for (std::vector<MeshPart *>::const_iterator it = (*itr)->parts.begin(); it != (*itr)->parts.end(); ++it)
+					partIndices.insert(std::make_pair(*it, (unsigned int)partIndices.size()));
+			for (std::vector<Mesh *>::const_iterator itr = model->meshes.begin(); itr != model->meshes.end(); ++itr) {
+				const Mesh &mesh = **itr;
+				put(meshes.data, (unsigned int)mesh.attributes.value);
+				put(meshes.data, mesh.vertexSize);
+				put(meshes.data, mesh.vertexSize == 0 ? 0u : (unsigned int)(mesh.vertices.size() / mesh.vertexSize));
+				put(meshes.data, parts.count);
+				put(meshes.data, (unsigned int)mesh.parts.size());
+				put(meshes.data, 0u);
+				put(meshes.data, dataSize = align(dataSize));
+				dataSize += mesh.vertices.size() * 4;
+				meshes.count++;
+				for (std::vector<MeshPart *>::const_iterator it = mesh.parts.begin(); it != mesh.parts.end(); ++it) {
+					const MeshPart &part = **it;
+					put(parts.data, addString(part.id));
+					put(parts.data, part.primitiveType);
+					put(parts.data, (unsigned int)part.indices.size());
+					put(parts.data, meshes.count - 1);
+					put(parts.data, dataSize = align(dataSize));
+					dataSize += part.indices.size() * 2;
+					put(parts.data, lods.count);
+					put(parts.data, (unsigned int)part.lods.size());
+					put(parts.data, part.bounds);
+					parts.count++;
+					for (std::vector<MeshPart *>::const_iterator lt = part.lods.begin(); lt != part.lods.end(); ++lt, lods.count++)
+						put(lods.data, partIndices[*lt]);
+				}
+			}
+
+			std::map<const Material *, unsigned int> materialIndices;
+			for (std::vector<Material *>::const_iterator itr = model->materials.begin(); itr != model->materials.end(); ++itr) {
+				const Material &material = **itr;
+				materialIndices.insert(std::make_pair(*itr, materials.count++));
+				put(materials.data, addString(material.id));
+				put(materials.data, (material.ambient.valid ? 0x01u : 0u) | (material.diffuse.valid ? 0x02u : 0u) | (material.emissive.valid ? 0x04u : 0u) |
+					(material.specular.valid ? 0x08u : 0u) | (material.shininess.valid ? 0x10u : 0u) | (material.opacity.valid ? 0x20u : 0u));
+				put(materials.data, material.ambient.value, 3);
+				put(materials.data, material.diffuse.value, 3);
+				put(materials.data, material.emissive.value, 3);
+				put(materials.data, material.specular.value, 3);
+				put(materials.data, material.shininess.value);
+				put(materials.data, material.opacity.valid ? material.opacity.value : 1.f);
+				put(materials.data, textures.count);
+				put(materials.data, (unsigned int)material.textures.size());
+				for (std::vector<Material::Texture *>::const_iterator it = material.textures.begin(); it != material.textures.end(); ++it, textures.count++) {
+					put(textures.data, addString((*it)->id));
+					put(textures.data, addString((*it)->path));
+					put(textures.data, (unsigned int)(*it)->usage);
+					put(textures.data, (*it)->uvTranslation, 2);
+					put(textures.data, (*it)->uvScale, 2);
+					put(textures.data, 0u);
+				}
+			}
+
+			// The node indices are needed for the bones, which may reference any node, so number them up front
+			std::vector<std::pair<const Node *, unsigned int> > order;
+			std::map<const Node *, unsigned int> nodeIndices;
+			for (std::vector<Node *>::const_iterator itr = model->nodes.begin(); itr != model->nodes.end(); ++itr)
+				addNode(order, nodeIndices, *itr, G3DM_NONE);
+			for (std::vector<std::pair<const Node *, unsigned int> >::const_iterator itr = order.begin(); itr != order.end(); ++itr) {
+				const Node &node = *itr->first;
+				put(nodes.data, addString(node.id));
+				put(nodes.data, itr->second);
+				put(nodes.data, (unsigned int)node.children.size());
+				put(nodes.data, nodeParts.count);
+				put(nodes.data, (unsigned int)node.parts.size());
+				put(nodes.data, 0u);
+				put(nodes.data, node.transform.translation, 3);
+				put(nodes.data, node.transform.rotation, 4);
+				put(nodes.data, node.transform.scale, 3);
+				put(nodes.data, node.bounds);
+				nodes.count++;
+				for (std::vector<NodePart *>::const_iterator it = node.parts.begin(); it != node.parts.end(); ++it, nodeParts.count++) {
+					const NodePart &nodePart = **it;
+					std::map<const MeshPart *, unsigned int>::const_iterator part = partIndices.find(nodePart.meshPart);
+					std::map<const Material *, unsigned int>::const_iterator material = materialIndices.find(nodePart.material);
+					put(nodeParts.data, part == partIndices.end() ? G3DM_NONE : part->second);
+					put(nodeParts.data, material == materialIndices.end() ? G3DM_NONE : material->second);
+					put(nodeParts.data, bones.count);
+					put(nodeParts.data, (unsigned int)nodePart.bones.size());
+					put(nodeParts.data, uvMappings.count);
+					put(nodeParts.data, (unsigned int)nodePart.uvMapping.size());
+					for (std::vector<std::pair<Node *, BindPose> >::const_iterator bt = nodePart.bones.begin(); bt != nodePart.bones.end(); ++bt, bones.count++) {
+						std::map<const Node *, unsigned int>::const_iterator node = nodeIndices.find(bt->first);
+						put(bones.data, node == nodeIndices.end() ? G3DM_NONE : node->second);
+						put(bones.data, bt->second.translation, 3);
+						put(bones.data, bt->second.rotation, 4);
+						put(bones.data, bt->second.scale, 3);
+						put(bones.data, 0u);
+					}
+					for (std::vector<std::vector<Material::Texture *> >::const_iterator ut = nodePart.uvMapping.begin(); ut != nodePart.uvMapping.end(); ++ut, uvMappings.count++) {
+						put(uvMappings.data, uvIndices.count);
+						put(uvMappings.data, (unsigned int)ut->size());
+						for (std::vector<Material::Texture *>::const_iterator tt = ut->begin(); tt != ut->end(); ++tt, uvIndices.count++)
+							put(uvIndices.data, (unsigned int)nodePart.material->getTextureIndex(*tt));
+					}
+				}
+			}
+
+			for (std::vector<Animation *>::const_iterator itr = model->animations.begin(); itr != model->animations.end(); ++itr, animations.count++) {
+				put(animations.data, addString((*itr)->id));
+				put(animations.data, nodeAnimations.count);
+				put(animations.data, (unsigned int)(*itr)->nodeAnimations.size());
+				put(animations.data, (*itr)->keytimes.empty() ? 0u : 1u);
+				for (std::vector<NodeAnimation *>::const_iterator it = (*itr)->nodeAnimations.begin(); it != (*itr)->nodeAnimations.end(); ++it, nodeAnimations.count++) {
+					const NodeAnimation &nodeAnimation = **it;
+					std::map<const Node *, unsigned int>::const_iterator node = nodeIndices.find(nodeAnimation.node);
+					put(nodeAnimations.data, node == nodeIndices.end() ? G3DM_NONE : node->second);
+					put(nodeAnimations.data, keyframes.count);
+					put(nodeAnimations.data, (unsigned int)nodeAnimation.keyframeCount());
+					put(nodeAnimations.data, flags(nodeAnimation.translate, nodeAnimation.rotate, nodeAnimation.scale));
+					Keyframe keyframe;
+					for (size_t k = 0; k < nodeAnimation.keyframeCount(); k++, keyframes.count++) {
+						nodeAnimation.getKeyframe(k, keyframe);
+						put(keyframes.data, keyframe.time);
+						put(keyframes.data, keyframe.translation, 3);
+						put(keyframes.data, keyframe.rotation, 4);
+						put(keyframes.data, keyframe.scale, 3);
+						put(keyframes.data, flags(keyframe.hasTranslation, keyframe.hasRotation, keyframe.hasScale));
+					}
+				}
+			}
+
+			// The string table is complete now, the buffers are written directly from the model in the DATA section
+			sections.front().data.swap(strings);
+			sections.front().count = (unsigned int)stringOffsets.size();
+
+			const unsigned int sectionCount = (unsigned int)sections.size() + 1;
+			std::vector<unsigned char> header;
+			header.push_back('G'); header.push_back('3'); header.push_back('D'); header.push_back('M');
+			put(header, (unsigned short)model->version[0]);
+			put(header, (unsigned short)model->version[1]);
+			put(header, G3DM_FORMAT_VERSION);
+			put(header, G3DM_HEADER_SIZE);
+			put(header, sectionCount);
+			put(header, G3DM_HEADER_SIZE);
+			put(header, 0u);
+			put(header, 0u);
+			unsigned long long offset = G3DM_HEADER_SIZE + sectionCount * G3DM_SECTION_ENTRY_SIZE;
+			for (std::vector<Section>::const_iterator itr = sections.begin(); itr != sections.end(); ++itr) {
+				put(header, itr->type);
+				put(header, itr->count);
+				put(header, offset = align(offset));
+				put(header, (unsigned long long)itr->data.size());
+				offset += itr->data.size();
+			}
+			put(header, fourcc("DATA"));
+			put(header, (unsigned int)(model->meshes.size() + partIndices.size()));
+			put(header, offset = align(offset));
+			put(header, dataSize);
+
+			writeBytes(header);
+			offset = header.size();
+			for (std::vector<Section>::const_iterator itr = sections.begin(); itr != sections.end(); ++itr) {
+				offset = pad(offset);
+				writeBytes(itr->data);
+				offset += itr->data.size();
+			}
+			offset = pad(offset);
+			for (std::vector<Mesh *>::const_iterator itr = model->meshes.begin(); itr != model->meshes.end(); ++itr) {
+				offset = pad(offset);
+				writeFloats((*itr)->vertices);
+				offset += (*itr)->vertices.size() * 4;
+				for (std::vector<MeshPart *>::const_iterator it = (*itr)->parts.begin(); it != (*itr)->parts.end(); ++it) {
+					offset = pad(offset);
+					writeShorts((*it)->indices);
+					offset += (*it)->indices.size() * 2;
+				}
+			}
+			clear();
+		}
+
+	private:
+		struct Section {
+			unsigned int type;
+			unsigned int count;
+			std::vector<unsigned char> data;
+		};
+
+		std::ostream &stream;
+		std::vector<Section> sections;
+		std::vector<unsigned char> strings;
+		std::map<std::string, unsigned int> stringOffsets;
+
+		void clear() {
+			sections.clear();
+			strings.clear();
+			stringOffsets.clear();
+		}
+
+		/** Add an empty section, the string table is always the first section */
+		Section &add(const char * const &type) {
+			if (sections.empty()) {
+				// Reserve enough room for all sections, so the returned references stay valid
+				sections.reserve(16);
+				sections.push_back(Section());
+				sections.back().type = fourcc("STRS");
+				sections.back().count = 0;
+			}
+			sections.push_back(Section());
+			sections.back().type = fourcc(type);
+			sections.back().count = 0;
+			return sections.back();
+		}
+
+		/** Returns the offset of the string in the string table, each string is only stored once */
+		unsigned int addString(const std::string &value) {
+			std::map<std::string, unsigned int>::const_iterator itr = stringOffsets.find(value);
+			if (itr != stringOffsets.end())
+				return itr->second;
+			const unsigned int result = (unsigned int)strings.size();
+			strings.insert(strings.end(), value.begin(), value.end());
+			strings.push_back(0);
+			stringOffsets.insert(std::make_pair(value, result));
+			return result;
+		}
+
+		void addNode(std::vector<std::pair<const Node *, unsigned int> > &order, std::map<const Node *, unsigned int> &indices, const Node * const &node, const unsigned int &parent) {
+			const unsigned int index = (unsigned int)order.size();
+			order.push_back(std::make_pair(node, parent));
+			indices.insert(std::make_pair(node, index));
+			for (std::vector<Node *>::const_iterator itr = node->children.begin(); itr != node->children.end(); ++itr)
+				addNode(order, indices, *itr, index);
+		}
+
+		static unsigned int fourcc(const char * const &type) {
+			return (unsigned int)(unsigned char)type[0] | ((unsigned int)(unsigned char)type[1] << 8) |
+				((unsigned int)(unsigned char)type[2] << 16) | ((unsigned int)(unsigned char)type[3] << 24);
+		}
+
+		static inline unsigned int flags(const bool &translation, const bool &rotation, const bool &scale) {
+			return (translation ? 0x01u : 0u) | (rotation ? 0x02u : 0u) | (scale ? 0x04u : 0u);
+		}
+
+		static inline unsigned long long align(const unsigned long long &offset) {
+			return (offset + G3DM_ALIGNMENT - 1) & ~(unsigned long long)(G3DM_ALIGNMENT - 1);
+		}
+
+		// The values are written byte by byte, which makes the output little endian regardless of the platform
+		static inline void put(std::vector<unsigned char> &out, const unsigned short &value) {
+			out.push_back((unsigned char)value);
+			out.push_back((unsigned char)(value >> 8));
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const unsigned int &value) {
+			out.push_back((unsigned char)value);
+			out.push_back((unsigned char)(value >> 8));
+			out.push_back((unsigned char)(value >> 16));
+			out.push_back((unsigned char)(value >> 24));
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const unsigned long long &value) {
+			put(out, (unsigned int)value);
+			put(out, (unsigned int)(value >> 32));
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const float &value) {
+			unsigned int bits;
+			memcpy(&bits, &value, 4);
+			put(out, bits);
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const float * const &values, const unsigned int &count) {
+			for (unsigned int i = 0; i < count; i++)
+				put(out, values[i]);
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const double * const &values, const unsigned int &count) {
+			for (unsigned int i = 0; i < count; i++)
+				put(out, (float)values[i]);
+		}
+
+		static inline void put(std::vector<unsigned char> &out, const Bounds &bounds) {
+			put(out, bounds.min, 3);
+			put(out, bounds.max, 3);
+			put(out, bounds.center, 3);
+			put(out, bounds.radius);
+		}
+
+		inline void writeBytes(const std::vector<unsigned char> &data) {
+			if (!data.empty())
+				stream.write((const char *)&data[0], data.size());
+		}
+
+		/** Write zeros up to the next aligned offset, returns the aligned offset */
+		unsigned long long pad(const unsigned long long &offset) {
+			static const char zeros[G3DM_ALIGNMENT] = {0};
+			const unsigned long long result = align(offset);
+			stream.write(zeros, (std::streamsize)(result - offset));
+			return result;
+		}
+
+		/** Write the buffer in blocks, to avoid a copy of the whole buffer when converting it to little endian */
+		template<class T> void writeBlocks(const std::vector<T> &values) {
+			static const unsigned int BLOCK = 4096;
+			std::vector<unsigned char> block;
+			block.reserve(BLOCK * sizeof(T));
+			for (typename std::vector<T>::const_iterator itr = values.begin(); itr != values.end(); ) {
+				block.clear();
+				for (unsigned int i = 0; i < BLOCK && itr != values.end(); ++i, ++itr)
+					put(block, *itr);
+				writeBytes(block);
+			}
+		}
+
+		inline void writeFloats(const std::vector<float> &values) {
+			writeBlocks(values);
+		}
+
+		inline void writeShorts(const std::vector<unsigned short> &values) {
+			writeBlocks(values);
+		}
+	};
+}
+}
+
+#endif //FBXCONV_MODELDATA_G3DMWRITER_H
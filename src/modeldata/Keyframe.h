@@ -20,6 +20,7 @@
 #ifndef MODELDATA_KEYFRAME_H
 #define MODELDATA_KEYFRAME_H
 
+#include <string.h>
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
@@ -53,6 +54,9 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 } }
 
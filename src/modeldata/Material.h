@@ -21,7 +21,8 @@
 #define MODELDATA_MATERIAL_H
 
 #include <vector>
-#include <fbxsdk.h>
+#include <stdarg.h>
+#include "fbxtypes.h"
 #include "../readers/matrix3.h"
 #include "../json/BaseJSONWriter.h"
 
@@ -53,6 +54,14 @@ namespace modeldata {
 				value[i] = (T)v[i];
 			valid = true;
 		}
+		bool operator==(const OptionalValue<T, n> &rhs) const {
+			if (valid != rhs.valid)
+				return false;
+			for (int i = 0; valid && i < n; i++)
+				if (value[i] != rhs.value[i])
+					return false;
+			return true;
+		}
 	};
 
 	template<typename T>
@@ -67,6 +76,9 @@ namespace modeldata {
 			valid = true;
 			value = v;
 		}
+		inline bool operator==(const OptionalValue<T, 1> &rhs) const {
+			return valid == rhs.valid && (!valid || value == rhs.value);
+		}
 	};
 
 	struct Material : public json::ConstSerializable {
@@ -88,6 +100,8 @@ namespace modeldata {
 			FbxFileTexture *source;
 			std::string id;
 			std::string path;
+			/** The name of the uv set the texture is mapped to, or an empty string if not specified */
+			std::string uvSet;
 			float uvTranslation[2];
 			float uvScale[2];
 			// FIXME add Matrix3<float> uvTransform;
@@ -98,6 +112,13 @@ namespace modeldata {
 				uvScale[0] = uvScale[1] = 1.f;
 			}
 
+			/** Whether both textures use the same file the same way, the id is ignored */
+			bool equals(const Texture &rhs) const {
+				return path == rhs.path && usage == rhs.usage && uvSet == rhs.uvSet &&
+					uvTranslation[0] == rhs.uvTranslation[0] && uvTranslation[1] == rhs.uvTranslation[1] &&
+					uvScale[0] == rhs.uvScale[0] && uvScale[1] == rhs.uvScale[1];
+			}
+
 			virtual void serialize(json::BaseJSONWriter &writer) const;
 		};
 
@@ -128,6 +149,17 @@ namespace modeldata {
 			return NULL;
 		}
 
+		/** Whether both materials have the same values and textures (in the same order), the id is ignored */
+		bool equals(const Material &rhs) const {
+			if (!(diffuse == rhs.diffuse && ambient == rhs.ambient && emissive == rhs.emissive && specular == rhs.specular &&
+					shininess == rhs.shininess && opacity == rhs.opacity) || textures.size() != rhs.textures.size())
+				return false;
+			for (unsigned int i = 0; i < textures.size(); i++)
+				if (!textures[i]->equals(*rhs.textures[i]))
+					return false;
+			return true;
+		}
+
 		int getTextureIndex(const Texture * const &texture) const {
 			int n = (int)textures.size();
 			for (int i = 0; i < n; i++)
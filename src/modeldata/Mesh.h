@@ -21,12 +21,30 @@
 #define MODELDATA_MESH_H
 
 #include <vector>
+#include <algorithm>
+#include <math.h>
 #include "MeshPart.h"
 #include "Attributes.h"
+#include "BlendShape.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
 namespace modeldata {
+	/** The per attribute tolerances within which two vertices are considered equal when welding */
+	struct WeldTolerance {
+		/** the maximum distance between two positions */
+		float position;
+		/** the minimum cosine of the angle between two normals, tangents or binormals */
+		float direction;
+		/** the maximum difference of each texture coordinate component */
+		float uv;
+		/** the maximum difference of each color component (0 to 1) */
+		float color;
+
+		WeldTolerance(const float &position = 0.f, const float &angle = 0.f, const float &uv = 0.f, const float &color = 0.f)
+			: position(position), direction((float)cos(angle * 3.14159265358979 / 180.0)), uv(uv), color(color) {}
+	};
+
 	/** A mesh is responsable for freeing all parts and vertices it contains. */
 	struct Mesh : public json::ConstSerializable {
 		/** the attributes the vertices in this mesh describe */
@@ -39,17 +57,30 @@ namespace modeldata {
 		std::vector<unsigned int> hashes;
 		/** the indexed parts of this mesh */
 		std::vector<MeshPart *> parts;
+		/** the blend shapes of this mesh, the vertices they change are referenced by index */
+		std::vector<BlendShape *> blendShapes;
+		/** whether to weld vertices within the tolerance instead of only merging identical vertices */
+		bool weld;
+		/** the tolerances used when welding vertices */
+		WeldTolerance tolerance;
+		/** spatial hash grid (position cell to vertex indices) for finding vertices to weld with */
+		std::vector<std::vector<unsigned int> > grid;
 
 		/** ctor */
-		Mesh() : attributes(0), vertexSize(0) {}
+		Mesh() : attributes(0), vertexSize(0), weld(false) {}
 
 		/** copy constructor */
-		Mesh(const Mesh &copyFrom) {
+		Mesh(const Mesh &copyFrom) : weld(false) {
 			attributes = copyFrom.attributes;
 			vertexSize = copyFrom.vertexSize;
 			vertices.insert(vertices.end(), copyFrom.vertices.begin(), copyFrom.vertices.end());
 			for (std::vector<MeshPart *>::const_iterator itr = copyFrom.parts.begin(); itr != copyFrom.parts.end(); ++itr)
 				parts.push_back(new MeshPart(**itr));
+			for (unsigned int i = 0; i < parts.size(); i++)
+				for (std::vector<MeshPart *>::const_iterator itr = copyFrom.parts[i]->lods.begin(); itr != copyFrom.parts[i]->lods.end(); ++itr)
+					parts[i]->lods.push_back(parts[std::find(copyFrom.parts.begin(), copyFrom.parts.end(), *itr) - copyFrom.parts.begin()]);
+			for (std::vector<BlendShape *>::const_iterator itr = copyFrom.blendShapes.begin(); itr != copyFrom.blendShapes.end(); ++itr)
+				blendShapes.push_back(new BlendShape(**itr));
 		}
 
 		~Mesh() {
@@ -59,10 +90,26 @@ namespace modeldata {
 		void clear() {
 			vertices.clear();
 			hashes.clear();
+			grid.clear();
+			weld = false;
 			attributes = vertexSize = 0;
 			for (std::vector<MeshPart *>::iterator itr = parts.begin(); itr != parts.end(); ++itr)
 				delete (*itr);
 			parts.clear();
+			for (std::vector<BlendShape *>::iterator itr = blendShapes.begin(); itr != blendShapes.end(); ++itr)
+				delete (*itr);
+			blendShapes.clear();
+		}
+
+		/** Free the vertices and the indices of the parts (e.g. after they're written), the parts remain valid */
+		void releaseData() {
+			std::vector<float>().swap(vertices);
+			std::vector<unsigned int>().swap(hashes);
+			std::vector<std::vector<unsigned int> >().swap(grid);
+			for (std::vector<MeshPart *>::iterator itr = parts.begin(); itr != parts.end(); ++itr)
+				std::vector<unsigned short>().swap((*itr)->indices);
+			for (std::vector<BlendShape *>::iterator itr = blendShapes.begin(); itr != blendShapes.end(); ++itr)
+				(*itr)->releaseData();
 		}
 
 		inline unsigned int indexCount() {
@@ -72,7 +119,18 @@ namespace modeldata {
 			return result;
 		}
 
+		/** Weld vertices within the specified tolerance, must be called after the attributes are set and before any vertex is added */
+		void setWeldTolerance(const WeldTolerance &tolerance) {
+			this->tolerance = tolerance;
+			weld = attributes.hasPosition();
+			grid.clear();
+			if (weld)
+				grid.resize(256);
+		}
+
 		inline unsigned int add(const float *vertex) {
+			if (weld)
+				return addWelded(vertex);
 			const unsigned int hash = calcHash(vertex, vertexSize);
 			const unsigned int n = (unsigned int)hashes.size();
 			for (unsigned int i = 0; i < n; i++)
@@ -98,6 +156,99 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
+
+	private:
+		/** Only the neighbouring grid cells have to be checked, because the cell size equals the position tolerance */
+		unsigned int addWelded(const float *vertex) {
+			long long cx, cy, cz;
+			getCell(vertex, cx, cy, cz);
+			const unsigned int mask = (unsigned int)grid.size() - 1;
+			for (long long x = cx - 1; x <= cx + 1; x++) {
+				for (long long y = cy - 1; y <= cy + 1; y++) {
+					for (long long z = cz - 1; z <= cz + 1; z++) {
+						const std::vector<unsigned int> &bucket = grid[cellHash(x, y, z) & mask];
+						for (std::vector<unsigned int>::const_iterator itr = bucket.begin(); itr != bucket.end(); ++itr)
+							if (compareWelded(&vertices[(*itr)*vertexSize], vertex))
+								return *itr;
+					}
+				}
+			}
+			const unsigned int n = (unsigned int)hashes.size();
+			if (n >= grid.size() * 2) {
+				const unsigned int size = (unsigned int)grid.size() * 2;
+				grid.clear();
+				grid.resize(size);
+				for (unsigned int i = 0; i < n; i++)
+					grid[hashes[i] & (size - 1)].push_back(i);
+			}
+			const unsigned int hash = cellHash(cx, cy, cz);
+			grid[hash & ((unsigned int)grid.size() - 1)].push_back(n);
+			hashes.push_back(hash);
+			vertices.insert(vertices.end(), &vertex[0], &vertex[vertexSize]);
+			return n;
+		}
+
+		inline void getCell(const float *vertex, long long &x, long long &y, long long &z) const {
+			const double size = tolerance.position > 0.f ? (double)tolerance.position : 1e-6;
+			x = (long long)floor((double)vertex[0] / size);
+			y = (long long)floor((double)vertex[1] / size);
+			z = (long long)floor((double)vertex[2] / size);
+		}
+
+		inline static unsigned int cellHash(const long long &x, const long long &y, const long long &z) {
+			return (unsigned int)((x * 73856093LL) ^ (y * 19349663LL) ^ (z * 83492791LL));
+		}
+
+		bool compareWelded(const float *lhs, const float *rhs) {
+			unsigned int offset = 0;
+			for (unsigned int a = 0; a < ATTRIBUTE_COUNT; a++) {
+				if (!attributes.has(a))
+					continue;
+				const unsigned int size = (unsigned int)ATTRIBUTE_SIZE(a);
+				const float *l = &lhs[offset], *r = &rhs[offset];
+				offset += size;
+				if (compare(l, r, size))
+					continue;
+				switch(a) {
+				case ATTRIBUTE_POSITION:
+					if ((l[0]-r[0])*(l[0]-r[0]) + (l[1]-r[1])*(l[1]-r[1]) + (l[2]-r[2])*(l[2]-r[2]) > tolerance.position * tolerance.position)
+						return false;
+					break;
+				case ATTRIBUTE_NORMAL:
+				case ATTRIBUTE_TANGENT:
+				case ATTRIBUTE_BINORMAL: {
+					const float len = sqrt((l[0]*l[0] + l[1]*l[1] + l[2]*l[2]) * (r[0]*r[0] + r[1]*r[1] + r[2]*r[2]));
+					if (len <= 0.f || (l[0]*r[0] + l[1]*r[1] + l[2]*r[2]) < tolerance.direction * len)
+						return false;
+					break;
+				}
+				case ATTRIBUTE_COLOR:
+					for (unsigned int i = 0; i < size; i++)
+						if (fabs(l[i] - r[i]) > tolerance.color)
+							return false;
+					break;
+				case ATTRIBUTE_COLORPACKED: {
+					const unsigned int lc = *(const unsigned int*)l, rc = *(const unsigned int*)r;
+					for (unsigned int i = 0; i < 32; i += 8)
+						if (fabs((float)((lc >> i) & 0xff) - (float)((rc >> i) & 0xff)) > tolerance.color * 255.f)
+							return false;
+					break;
+				}
+				default:
+					if (a >= ATTRIBUTE_TEXCOORD0 && a <= ATTRIBUTE_TEXCOORD7) {
+						if (fabs(l[0] - r[0]) > tolerance.uv || fabs(l[1] - r[1]) > tolerance.uv)
+							return false;
+					}
+					else // Blend weights (and unknown attributes) must be identical
+						return false;
+					break;
+				}
+			}
+			return true;
+		}
 	};
 }
 }
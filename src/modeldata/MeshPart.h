@@ -27,7 +27,8 @@
 #define PRIMITIVETYPE_TRIANGLESTRIP	5
 
 #include <string>
-#include <fbxsdk.h>
+#include "fbxtypes.h"
+#include "Bounds.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
@@ -37,10 +38,14 @@ namespace modeldata {
 		std::vector<unsigned short> indices;
 		unsigned int primitiveType;
 		std::vector<FbxCluster *> sourceBones;
+		/** the reduced levels of detail of this part, from high to low detail (the parts are owned by the mesh) */
+		std::vector<MeshPart *> lods;
+		/** the bounds of the vertices referenced by this part, in bind pose for skinned parts */
+		Bounds bounds;
 
 		MeshPart() : primitiveType(0) {}
 
-		MeshPart(const MeshPart &copyFrom) {
+		MeshPart(const MeshPart &copyFrom) : bounds(copyFrom.bounds) {
 			set(copyFrom.id.c_str(), copyFrom.primitiveType, copyFrom.indices);
 		}
 
@@ -52,6 +57,7 @@ namespace modeldata {
 			indices.clear();
 			id.clear();
 			primitiveType = 0;
+			bounds.clear();
 		}
 
 		void set(const char *id, const unsigned int &primitiveType, const std::vector<unsigned short> &indices) {
@@ -62,6 +68,9 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 }
 }
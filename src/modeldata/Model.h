@@ -26,6 +26,7 @@
 #include "Material.h"
 #include "Mesh.h"
 #include "Node.h"
+#include "Skeleton.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
@@ -41,6 +42,8 @@ namespace modeldata {
 		std::vector<Material *> materials;
 		std::vector<Mesh *> meshes;
 		std::vector<Node *> nodes;
+		/** The joints referenced by the node parts, or empty if the node parts contain the bind pose of their bones */
+		Skeleton skeleton;
 
 		Model() { version[0] = VERSION_HI; version[1] = VERSION_LO; }
 
@@ -56,6 +59,9 @@ namespace modeldata {
 				meshes.push_back(new Mesh(**itr));
 			for (std::vector<Node *>::const_iterator itr = copyFrom.nodes.begin(); itr != copyFrom.nodes.end(); ++itr)
 				nodes.push_back(new Node(**itr));
+			// The joints refer to the nodes of copyFrom, use the copied node with the same id instead
+			for (unsigned int i = 0; i < copyFrom.skeleton.joints.size(); i++)
+				skeleton.add(getNode(copyFrom.skeleton.joints[i]->id.c_str()), &copyFrom.skeleton.inverseBindMatrices[i * 16]);
 		}
 
 		~Model() {
@@ -75,6 +81,7 @@ namespace modeldata {
 			for (std::vector<Node *>::iterator itr = nodes.begin(); itr != nodes.end(); ++itr)
 				delete *itr;
 			nodes.clear();
+			skeleton.clear();
 		}
 
 		Node *getNode(const char *id) const {
@@ -88,6 +95,13 @@ namespace modeldata {
 			return NULL;
 		}
 
+		Animation *getAnimation(const char *id) const {
+			for (std::vector<Animation *>::const_iterator itr = animations.begin(); itr != animations.end(); ++itr)
+				if ((*itr)->id.compare(id)==0)
+					return *itr;
+			return NULL;
+		}
+
 		Material *getMaterial(const char *id) const {
 			for (std::vector<Material *>::const_iterator itr = materials.begin(); itr != materials.end(); ++itr)
 				if ((*itr)->id.compare(id)==0)
@@ -138,6 +152,9 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 }
 }
@@ -21,8 +21,10 @@
 #define MODELDATA_NODE_H
 
 #include <vector>
-#include <fbxsdk.h>
+#include <string.h>
+#include "fbxtypes.h"
 #include "NodePart.h"
+#include "Bounds.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
@@ -38,9 +40,12 @@ namespace modeldata {
 		std::vector<NodePart *> parts;
 		std::vector<Node *> children;
 		FbxNode *source;
+		/** the bounds of the parts of this node and all its children, in the coordinate system of this node */
+		Bounds bounds;
 
 		Node(const char *id = NULL) : source(0) {
 			memset(&transform, 0, sizeof(transform));
+			transform.rotation[3] = 1.f;
 			transform.scale[0] = transform.scale[1] = transform.scale[2] = 1.f;
 			if (id != NULL)
 				this->id = id;
@@ -49,6 +54,7 @@ namespace modeldata {
 		Node(const Node &copyFrom) {
 			id = copyFrom.id;
 			source = copyFrom.source;
+			bounds = copyFrom.bounds;
 			memcpy(&transform, &(copyFrom.transform), sizeof(transform));
 			for (std::vector<NodePart *>::const_iterator itr = copyFrom.parts.begin(); itr != copyFrom.parts.end(); ++itr)
 				parts.push_back(new NodePart(**itr));
@@ -98,6 +104,9 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 }
 }
@@ -21,36 +21,67 @@
 #define MODELDATA_NODEANIMATION_H
 
 #include <vector>
+#include <string.h>
 #include "Keyframe.h"
+#include "Node.h"
 #include "../json/BaseJSONWriter.h"
 
 namespace fbxconv {
 namespace modeldata {
-	struct Node;
-
+	/** The keyframes of a node, stored as tracks: the time of each keyframe and the values of the animated components of
+	 * each keyframe in contiguous arrays. */
 	struct NodeAnimation : public json::ConstSerializable {
 		const Node *node;
-		std::vector<Keyframe *> keyframes;
+		/** The time (in milliseconds) of each keyframe */
+		std::vector<float> keytimes;
+		/** The translation (x, y, z) of each keyframe, empty if the translation isn't animated */
+		std::vector<float> translations;
+		/** The rotation (quaternion x, y, z, w) of each keyframe, empty if the rotation isn't animated */
+		std::vector<float> rotations;
+		/** The scale (x, y, z) of each keyframe, empty if the scale isn't animated */
+		std::vector<float> scales;
 		bool translate, rotate, scale;
+		/** Whether to write the tracks as arrays of values, instead of an object per keyframe */
+		bool tracks;
+		/** The time (in milliseconds) between two frames the keyframes are sampled at, or 0 if unknown */
+		float frameTime;
+		/** The maximum error of the quantized tracks, or 0 to write the tracks unquantized (see QuantizedTracks) */
+		float tolerance;
+		/** Whether the keytimes are those of the animation (shared by all its node animations), so they aren't written with the tracks */
+		bool sharedKeytimes;
+
+		NodeAnimation() : node(0), translate(false), rotate(false), scale(false), tracks(false), frameTime(0.f), tolerance(0.f), sharedKeytimes(false) {}
 
-		NodeAnimation() : node(0), translate(false), rotate(false), scale(false) {}
+		inline size_t keyframeCount() const {
+			return keytimes.size();
+		}
 
-		NodeAnimation(const NodeAnimation &copyFrom) {
-			node = copyFrom.node;
-			translate = copyFrom.translate;
-			rotate = copyFrom.rotate;
-			scale = copyFrom.scale;
-			for (std::vector<Keyframe *>::const_iterator itr = copyFrom.keyframes.begin(); itr != copyFrom.keyframes.end(); ++itr)
-				keyframes.push_back(new Keyframe(*(*itr)));
+		/** Add the keyframe to the end of the tracks, only the components which are animated (translate, rotate, scale) are stored */
+		void addKeyframe(const Keyframe &keyframe) {
+			keytimes.push_back(keyframe.time);
+			if (translate)
+				translations.insert(translations.end(), keyframe.translation, keyframe.translation + 3);
+			if (rotate)
+				rotations.insert(rotations.end(), keyframe.rotation, keyframe.rotation + 4);
+			if (scale)
+				scales.insert(scales.end(), keyframe.scale, keyframe.scale + 3);
 		}
 
-		~NodeAnimation() {
-			for (std::vector<Keyframe *>::iterator itr = keyframes.begin(); itr != keyframes.end(); ++itr)
-				if ((*itr)!=0)
-					delete *itr;
+		/** Get the keyframe at the specified index, the components which aren't animated are set to the transform of the node */
+		void getKeyframe(const size_t &index, Keyframe &keyframe) const {
+			keyframe.time = keytimes[index];
+			memcpy(keyframe.translation, translate ? &translations[index * 3] : node->transform.translation, sizeof(keyframe.translation));
+			memcpy(keyframe.rotation, rotate ? &rotations[index * 4] : node->transform.rotation, sizeof(keyframe.rotation));
+			memcpy(keyframe.scale, scale ? &scales[index * 3] : node->transform.scale, sizeof(keyframe.scale));
+			keyframe.hasTranslation = translate;
+			keyframe.hasRotation = rotate;
+			keyframe.hasScale = scale;
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 } }
 
@@ -28,16 +28,27 @@
 namespace fbxconv {
 namespace modeldata {
 	struct Node;
+	/** The bind pose of a bone, the decomposed transform (translation and scale including the w component, as written to
+	 * g3dj and g3db) and its inverse matrix (4x4, column major) */
+	struct BindPose {
+		float translation[4];
+		float rotation[4];
+		float scale[4];
+		float inverse[16];
+	};
+
 	/** A nodepart references (but not owns) a meshpart and a material */
 	struct NodePart : public json::ConstSerializable {
 		const MeshPart *meshPart;
 		const Material *material;
-		std::vector<std::pair<Node *, FbxAMatrix> > bones;
+		std::vector<std::pair<Node *, BindPose> > bones;
+		/** The index of each bone within the skeleton of the model, or empty to write the bind pose of the bones */
+		std::vector<unsigned int> joints;
 		std::vector<std::vector<Material::Texture *> > uvMapping;
 
 		NodePart() : meshPart(0), material(0) {}
 
-		NodePart(const NodePart &copyFrom) : meshPart(copyFrom.meshPart), material(copyFrom.material) {
+		NodePart(const NodePart &copyFrom) : meshPart(copyFrom.meshPart), material(copyFrom.material), joints(copyFrom.joints) {
 			bones.insert(bones.end(), copyFrom.bones.begin(), copyFrom.bones.end());
 			uvMapping.resize(copyFrom.uvMapping.size());
 			for (unsigned int i = 0; i < uvMapping.size(); i++)
@@ -45,6 +56,9 @@ namespace modeldata {
 		}
 
 		virtual void serialize(json::BaseJSONWriter &writer) const;
+		virtual void serialize(json::JSONWriter &writer) const;
+		virtual void serialize(json::UBJSONWriter &writer) const;
+		template<class W> void write(W &writer) const;
 	};
 }
 }
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELDATA_QUANTIZEDTRACKS_H
+#define FBXCONV_MODELDATA_QUANTIZEDTRACKS_H
+
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include "NodeAnimation.h"
+
+namespace fbxconv {
+namespace modeldata {
+	/** The largest value of a quantized translation or scale component */
+	const unsigned int QUANTIZE_RANGE_MAX = 65535;
+	/** The largest value of a quantized rotation component */
+	const unsigned int QUANTIZE_ROTATION_MAX = 32767;
+	/** The smallest three components of a normalized quaternion are within plus or minus the square root of a half */
+	const float QUANTIZE_ROTATION_RANGE = 0.70710678f;
+	/** The maximum distance (in frames) between a keytime and the frame it is quantized to */
+	const float QUANTIZE_FRAME_TOLERANCE = 0.01f;
+
+	/** The tracks of a node animation quantized to 16 bit values. A track is only quantized if every decoded value is within
+	 * the tolerance of the original value, otherwise it is left empty and the track should be written as floats.
+	 *   frames       the keytimes as the number of frames (of frameTime milliseconds) since the previous keyframe, the
+	 *                first keyframe since the start of the animation
+	 *   translations the translation (x, y, z) of each keyframe within the bounds of the track:
+	 *                value = min + q * (max - min) / 65535
+	 *   rotations    the rotation of each keyframe as the smallest three components of the quaternion (48 bits): the largest
+	 *                component is made positive and left out, its index is stored in the highest bit of the first (high bit
+	 *                of the index) and second (low bit) value. The other components are stored in the lower 15 bits of the
+	 *                three values in order: value = q * sqrt(2) / 32767 - sqrt(0.5). The largest component is
+	 *                sqrt(1 - x * x - y * y - z * z).
+	 *   scales       the scale (x, y, z) of each keyframe within the bounds of the track, like translations */
+	struct QuantizedTracks {
+		std::vector<unsigned short> frames;
+		std::vector<unsigned short> translations;
+		std::vector<unsigned short> rotations;
+		std::vector<unsigned short> scales;
+		/** The minimum (x, y, z) followed by the maximum (x, y, z) of the translation track */
+		float translationBounds[6];
+		/** The minimum (x, y, z) followed by the maximum (x, y, z) of the scale track */
+		float scaleBounds[6];
+
+		/** Quantize the tracks of the animation, a tolerance of zero (or less) leaves all tracks unquantized */
+		QuantizedTracks(const NodeAnimation &animation, const float &tolerance) {
+			memset(translationBounds, 0, sizeof(translationBounds));
+			memset(scaleBounds, 0, sizeof(scaleBounds));
+			if (tolerance <= 0.f)
+				return;
+			quantizeTimes(animation.keytimes, animation.frameTime, frames);
+			if (animation.translate)
+				quantizeRange(animation.translations, tolerance, translations, translationBounds);
+			if (animation.rotate)
+				quantizeRotations(animation.rotations, tolerance, rotations);
+			if (animation.scale)
+				quantizeRange(animation.scales, tolerance, scales, scaleBounds);
+		}
+
+		/** Quantize the keytimes to (delta encoded) frame indices, returns false if a keytime isn't on a frame */
+		static bool quantizeTimes(const std::vector<float> &keytimes, const float &frameTime, std::vector<unsigned short> &out) {
+			out.clear();
+			if (frameTime <= 0.f)
+				return false;
+			long previous = 0;
+			for (std::vector<float>::const_iterator itr = keytimes.begin(); itr != keytimes.end(); ++itr) {
+				const double frames = (double)(*itr) / (double)frameTime;
+				const long frame = (long)floor(frames + 0.5);
+				if (fabs(frames - (double)frame) > QUANTIZE_FRAME_TOLERANCE || frame < previous || frame - previous > (long)QUANTIZE_RANGE_MAX) {
+					out.clear();
+					return false;
+				}
+				out.push_back((unsigned short)(frame - previous));
+				previous = frame;
+			}
+			return true;
+		}
+
+		/** Quantize the three component values within the bounds of the track (min followed by max), returns false if the
+		 * error of a value exceeds the tolerance */
+		static bool quantizeRange(const std::vector<float> &values, const float &tolerance, std::vector<unsigned short> &out, float * const &bounds) {
+			out.clear();
+			if (values.empty())
+				return false;
+			for (int c = 0; c < 3; c++)
+				bounds[c] = bounds[c + 3] = values[c];
+			for (std::vector<float>::size_type i = 3; i < values.size(); i++) {
+				const int c = (int)(i % 3);
+				if (values[i] < bounds[c])
+					bounds[c] = values[i];
+				if (values[i] > bounds[c + 3])
+					bounds[c + 3] = values[i];
+			}
+			out.reserve(values.size());
+			for (std::vector<float>::size_type i = 0; i < values.size(); i++) {
+				const int c = (int)(i % 3);
+				const float range = bounds[c + 3] - bounds[c];
+				const unsigned short q = range > 0.f ? (unsigned short)floor((values[i] - bounds[c]) / range * (float)QUANTIZE_RANGE_MAX + 0.5f) : 0;
+				if (fabs(decodeRange(q, bounds[c], bounds[c + 3]) - values[i]) > tolerance) {
+					out.clear();
+					return false;
+				}
+				out.push_back(q);
+			}
+			return true;
+		}
+
+		/** Quantize the quaternions (x, y, z, w) to their smallest three components, returns false if the error of a
+		 * component exceeds the tolerance */
+		static bool quantizeRotations(const std::vector<float> &values, const float &tolerance, std::vector<unsigned short> &out) {
+			out.clear();
+			if (values.empty())
+				return false;
+			out.reserve(values.size() / 4 * 3);
+			unsigned short q[3];
+			float decoded[4];
+			for (std::vector<float>::size_type i = 0; i + 3 < values.size(); i += 4) {
+				const float * const rotation = &values[i];
+				int largest = 0;
+				for (int c = 1; c < 4; c++)
+					if (fabs(rotation[c]) > fabs(rotation[largest]))
+						largest = c;
+				// q and -q are the same rotation
+				const float sign = rotation[largest] < 0.f ? -1.f : 1.f;
+				for (int c = 0, j = 0; c < 4; c++) {
+					if (c == largest)
+						continue;
+					const float v = (sign * rotation[c] + QUANTIZE_ROTATION_RANGE) / (2.f * QUANTIZE_ROTATION_RANGE) * (float)QUANTIZE_ROTATION_MAX;
+					q[j++] = (unsigned short)(v <= 0.f ? 0 : (v >= (float)QUANTIZE_ROTATION_MAX ? QUANTIZE_ROTATION_MAX : (unsigned int)floor(v + 0.5f)));
+				}
+				q[0] |= (unsigned short)((largest >> 1) << 15);
+				q[1] |= (unsigned short)((largest & 1) << 15);
+				decodeRotation(q, decoded);
+				for (int c = 0; c < 4; c++) {
+					if (fabs(decoded[c] - sign * rotation[c]) > tolerance) {
+						out.clear();
+						return false;
+					}
+				}
+				out.insert(out.end(), q, q + 3);
+			}
+			return true;
+		}
+
+		static inline float decodeRange(const unsigned short &q, const float &min, const float &max) {
+			return min + (float)q * (max - min) / (float)QUANTIZE_RANGE_MAX;
+		}
+
+		static void decodeRotation(const unsigned short * const &q, float * const &rotation) {
+			const int largest = ((q[0] >> 15) << 1) | (q[1] >> 15);
+			float sum = 0.f;
+			for (int c = 0, j = 0; c < 4; c++) {
+				if (c == largest)
+					continue;
+				const float v = (float)(q[j++] & 0x7FFF) * (2.f * QUANTIZE_ROTATION_RANGE) / (float)QUANTIZE_ROTATION_MAX - QUANTIZE_ROTATION_RANGE;
+				rotation[c] = v;
+				sum += v * v;
+			}
+			rotation[largest] = sum < 1.f ? sqrt(1.f - sum) : 0.f;
+		}
+	};
+}
+}
+
+#endif //FBXCONV_MODELDATA_QUANTIZEDTRACKS_H
@@ -19,11 +19,16 @@
 #include "Animation.h"
 #include "NodeAnimation.h"
 #include "Keyframe.h"
+#include "QuantizedTracks.h"
+#include "Skeleton.h"
 #include "Material.h"
 #include "Attributes.h"
 #include "MeshPart.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "Bounds.h"
+#include "../json/JSONWriter.h"
+#include "../json/UBJSONWriter.h"
 
 namespace fbxconv {
 namespace modeldata {
@@ -72,22 +77,36 @@ static const char* getTextureUseString(const Material::Texture::Usage &textureUs
 	}
 }
 
-void Model::serialize(json::BaseJSONWriter &writer) const {
-	writer.obj(6);
+template<class W> void Model::write(W &writer) const {
+	writer.obj(skeleton.empty() ? 6 : 7);
 	writer << "version" = version;
 	writer << "id" = id;
 	writer << "meshes" = meshes;
 	writer << "materials" = materials;
+	if (!skeleton.empty())
+		writer << "skeleton" = skeleton;
 	writer << "nodes" = nodes;
 	writer << "animations" = animations;
 	writer.end();
 }
 
-void Mesh::serialize(json::BaseJSONWriter &writer) const {
-	writer.obj(3);
+template<class W> void Mesh::write(W &writer) const {
+	writer.obj(blendShapes.empty() ? 3 : 4);
 	writer << "attributes" = attributes;
 	writer.val("vertices").is().data(vertices, vertexSize);
 	writer << "parts" = parts;
+	if (!blendShapes.empty())
+		writer << "blendShapes" = blendShapes;
+	writer.end();
+}
+
+void BlendShape::serialize(json::BaseJSONWriter &writer) const {
+	writer.obj(normals.empty() ? 3 : 4);
+	writer << "id" = id;
+	writer.val("indices").is().data(indices, 12);
+	writer.val("positions").is().data(positions, 3);
+	if (!normals.empty())
+		writer.val("normals").is().data(normals, 3);
 	writer.end();
 }
 
@@ -99,11 +118,19 @@ void Attributes::serialize(json::BaseJSONWriter &writer) const {
 	writer.end();
 }
 
-void MeshPart::serialize(json::BaseJSONWriter &writer) const {
-	writer.obj(3);
+template<class W> void MeshPart::write(W &writer) const {
+	writer.obj(3 + (lods.empty() ? 0 : 1) + (bounds.isValid() ? 1 : 0));
 	writer << "id" = id;
 	writer << "type" = getPrimitiveTypeString(primitiveType);
 	writer.val("indices").is().data(indices, 12);
+	if (bounds.isValid())
+		writer << "bounds" = bounds;
+	if (!lods.empty()) {
+		writer.val("lods").is().arr(lods.size(), 16);
+		for (std::vector<MeshPart *>::const_iterator it = lods.begin(); it != lods.end(); ++it)
+			writer << (*it)->id;
+		writer.end();
+	}
 	writer << json::end;
 }
 
@@ -139,7 +166,7 @@ void Material::Texture::serialize(json::BaseJSONWriter &writer) const {
 	writer << json::end;
 }
 
-void Node::serialize(json::BaseJSONWriter &writer) const {
+template<class W> void Node::write(W &writer) const {
 	writer << json::obj;
 	writer << "id" = id;
 	if (transform.rotation[0] != 0. || transform.rotation[1] != 0. || transform.rotation[2] != 0. || transform.rotation[3] != 1.)
@@ -150,30 +177,36 @@ void Node::serialize(json::BaseJSONWriter &writer) const {
 		writer << "translation" = transform.translation;
 	if (!parts.empty())
 		writer << "parts" = parts;
+	if (bounds.isValid())
+		writer << "bounds" = bounds;
 	if (!children.empty())
 		writer << "children" = children;
 	writer << json::end;
 }
 
-template<class T, size_t n> void writeAsFloat(json::BaseJSONWriter &writer, const char *k, const T(&v)[n]) {
-	static float tmp[n];
-	for (int i = 0; i < n; ++i)
-		tmp[i] = (float)v[i];
-	writer << k << tmp;
+template<class W> void Bounds::write(W &writer) const {
+	writer.obj(4);
+	writer << "min" = min;
+	writer << "max" = max;
+	writer << "center" = center;
+	writer << "radius" = radius;
+	writer << json::end;
 }
 
-void NodePart::serialize(json::BaseJSONWriter &writer) const {
+template<class W> void NodePart::write(W &writer) const {
 	writer << json::obj;
 	writer << "meshpartid" = meshPart->id;
 	writer << "materialid" = material->id;
-	if (!bones.empty()) {
+	if (!joints.empty())
+		writer << "joints" = joints;
+	else if (!bones.empty()) {
 		writer.val("bones").is().arr();
-		for (std::vector<std::pair<Node *, FbxAMatrix> >::const_iterator it = bones.begin(); it != bones.end(); ++it) {
+		for (std::vector<std::pair<Node *, BindPose> >::const_iterator it = bones.begin(); it != bones.end(); ++it) {
 			writer << json::obj;
 			writer << "node" = it->first->id;
-			writeAsFloat(writer, "translation", it->second.GetT().mData);
-			writeAsFloat(writer, "rotation", it->second.GetQ().mData);
-			writeAsFloat(writer, "scale", it->second.GetS().mData);
+			writer << "translation" << it->second.translation;
+			writer << "rotation" << it->second.rotation;
+			writer << "scale" << it->second.scale;
 			writer << json::end;
 		}
 		writer.end();
@@ -191,21 +224,86 @@ void NodePart::serialize(json::BaseJSONWriter &writer) const {
 	writer << json::end;
 }
 
-void Animation::serialize(json::BaseJSONWriter &writer) const {
+void Skeleton::serialize(json::BaseJSONWriter &writer) const {
 	writer.obj(2);
+	writer.val("joints").is().arr(joints.size(), 8);
+	for (std::vector<const Node *>::const_iterator itr = joints.begin(); itr != joints.end(); ++itr)
+		writer << (*itr)->id;
+	writer.end();
+	writer.val("inverseBindMatrices").is().data(inverseBindMatrices, 16);
+	writer.end();
+}
+
+template<class W> void Animation::write(W &writer) const {
+	std::vector<unsigned short> frames;
+	if (tolerance > 0.f)
+		QuantizedTracks::quantizeTimes(keytimes, frameTime, frames);
+	writer.obj(2 + (keytimes.empty() ? 0 : (frames.empty() ? 1 : 2)) + (blendShapeAnimations.empty() ? 0 : 1));
 	writer << "id" = id;
+	if (!keytimes.empty() && frames.empty())
+		writer << "keytimes" = keytimes;
+	else if (!keytimes.empty()) {
+		writer << "frameTime" = frameTime;
+		writer << "frames" = frames;
+	}
 	writer << "bones" = nodeAnimations;
+	if (!blendShapeAnimations.empty())
+		writer << "blendShapes" = blendShapeAnimations;
 	writer.end();
 }
 
-void NodeAnimation::serialize(json::BaseJSONWriter &writer) const {
+void BlendShapeAnimation::serialize(json::BaseJSONWriter &writer) const {
+	writer.obj(3);
+	writer << "blendShapeId" = shape->id;
+	writer << "keytimes" = keytimes;
+	writer << "weights" = weights;
+	writer.end();
+}
+
+template<class W> void NodeAnimation::write(W &writer) const {
+	if (tracks) {
+		const QuantizedTracks quantized(*this, tolerance);
+		writer.obj(1 + (sharedKeytimes ? 0 : (quantized.frames.empty() ? 1 : 2)) + (translate ? (quantized.translations.empty() ? 1 : 2) : 0) +
+			(rotate ? 1 : 0) + (scale ? (quantized.scales.empty() ? 1 : 2) : 0));
+		writer << "boneId" = node->id;
+		if (!sharedKeytimes && quantized.frames.empty())
+			writer << "keytimes" = keytimes;
+		else if (!sharedKeytimes) {
+			writer << "frameTime" = frameTime;
+			writer << "frames" = quantized.frames;
+		}
+		if (translate && quantized.translations.empty())
+			writer << "translation" = translations;
+		else if (translate) {
+			writer << "translationBounds" = quantized.translationBounds;
+			writer << "quantizedTranslation" = quantized.translations;
+		}
+		if (rotate && quantized.rotations.empty())
+			writer << "rotation" = rotations;
+		else if (rotate)
+			writer << "quantizedRotation" = quantized.rotations;
+		if (scale && quantized.scales.empty())
+			writer << "scale" = scales;
+		else if (scale) {
+			writer << "scaleBounds" = quantized.scaleBounds;
+			writer << "quantizedScale" = quantized.scales;
+		}
+		writer.end();
+		return;
+	}
 	writer.obj(2);
 	writer << "boneId" = node->id;
-	writer << "keyframes" = keyframes;
+	writer.val("keyframes").is().arr((long long)keytimes.size());
+	Keyframe keyframe;
+	for (size_t i = 0; i < keytimes.size(); i++) {
+		getKeyframe(i, keyframe);
+		writer << keyframe;
+	}
+	writer.end();
 	writer.end();
 }
 
-void Keyframe::serialize(json::BaseJSONWriter &writer) const {
+template<class W> void Keyframe::write(W &writer) const {
 	writer << json::obj;
 	writer << "keytime" = time;
 	if (hasRotation)
@@ -217,4 +315,22 @@ void Keyframe::serialize(json::BaseJSONWriter &writer) const {
 	writer << json::end;
 }
 
+// The overloads write through the concrete writer, so only the objects (not each of their values) are dispatched virtually
+#define SERIALIZE_WITH_WRITERS(T) \
+	void T::serialize(json::BaseJSONWriter &writer) const { write(writer); } \
+	void T::serialize(json::JSONWriter &writer) const { write(writer); } \
+	void T::serialize(json::UBJSONWriter &writer) const { write(writer); }
+
+SERIALIZE_WITH_WRITERS(Model)
+SERIALIZE_WITH_WRITERS(Mesh)
+SERIALIZE_WITH_WRITERS(MeshPart)
+SERIALIZE_WITH_WRITERS(Node)
+SERIALIZE_WITH_WRITERS(Bounds)
+SERIALIZE_WITH_WRITERS(NodePart)
+SERIALIZE_WITH_WRITERS(Animation)
+SERIALIZE_WITH_WRITERS(NodeAnimation)
+SERIALIZE_WITH_WRITERS(Keyframe)
+
+#undef SERIALIZE_WITH_WRITERS
+
 } }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELDATA_SKELETON_H
+#define FBXCONV_MODELDATA_SKELETON_H
+
+#include <vector>
+#include <map>
+#include <string.h>
+#include "Node.h"
+#include "NodePart.h"
+#include "../json/BaseJSONWriter.h"
+
+namespace fbxconv {
+namespace modeldata {
+	/** The joints of all skinned node parts of a model, each bone (node and bind pose) is listed once, so the node parts
+	 * can reference the joints by index instead of repeating their bind pose. */
+	struct Skeleton : public json::ConstSerializable {
+		/** The node of each joint */
+		std::vector<const Node *> joints;
+		/** The inverse bind matrix (4x4, column major) of each joint */
+		std::vector<float> inverseBindMatrices;
+
+		inline bool empty() const {
+			return joints.empty();
+		}
+
+		void clear() {
+			joints.clear();
+			inverseBindMatrices.clear();
+			nodeJoints.clear();
+		}
+
+		/** Add the bones of the parts of the nodes and their children as joints and set the joint indices of each part */
+		void build(const std::vector<Node *> &nodes) {
+			for (std::vector<Node *>::const_iterator itr = nodes.begin(); itr != nodes.end(); ++itr) {
+				for (std::vector<NodePart *>::const_iterator it = (*itr)->parts.begin(); it != (*itr)->parts.end(); ++it) {
+					(*it)->joints.clear();
+					for (std::vector<std::pair<Node *, BindPose> >::const_iterator bt = (*it)->bones.begin(); bt != (*it)->bones.end(); ++bt)
+						(*it)->joints.push_back(add(bt->first, bt->second));
+				}
+				build((*itr)->children);
+			}
+		}
+
+		/** Add the joint if not already added, returns the index of the joint */
+		unsigned int add(const Node * const &node, const BindPose &bindPose) {
+			return add(node, bindPose.inverse);
+		}
+
+		/** Add the joint with the specified inverse bind matrix if not already added, returns the index of the joint */
+		unsigned int add(const Node * const &node, const float * const &inverseBindMatrix) {
+			std::vector<unsigned int> &candidates = nodeJoints[node];
+			for (std::vector<unsigned int>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+				if (memcmp(&inverseBindMatrices[(*itr) * 16], inverseBindMatrix, 16 * sizeof(float)) == 0)
+					return *itr;
+			const unsigned int index = (unsigned int)joints.size();
+			candidates.push_back(index);
+			joints.push_back(node);
+			inverseBindMatrices.insert(inverseBindMatrices.end(), inverseBindMatrix, inverseBindMatrix + 16);
+			return index;
+		}
+
+		virtual void serialize(json::BaseJSONWriter &writer) const;
+	private:
+		/** The indices of the joints of each node */
+		std::map<const Node *, std::vector<unsigned int> > nodeJoints;
+	};
+} }
+
+#endif //FBXCONV_MODELDATA_SKELETON_H
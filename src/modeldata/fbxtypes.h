@@ -0,0 +1,34 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+/** @author Xoppa */
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_MODELDATA_FBXTYPES_H
+#define FBXCONV_MODELDATA_FBXTYPES_H
+
+/** The model data only keeps pointers to the FBX SDK objects it was converted from. When building without the FBX SDK
+ * (FBXCONV_NO_FBXSDK, e.g. to only convert OBJ files) these types are declared but never defined. */
+#ifdef FBXCONV_NO_FBXSDK
+class FbxNode;
+class FbxCluster;
+class FbxFileTexture;
+class FbxSurfaceMaterial;
+#else
+#include <fbxsdk.h>
+#endif
+
+#endif //FBXCONV_MODELDATA_FBXTYPES_H
@@ -25,30 +25,19 @@
 #include "Reader.h"
 #include <sstream>
 #include <map>
+#include <set>
 #include <algorithm>
 #include "util.h"
 #include "FbxMeshInfo.h"
+#include "TextureFileInfo.h"
+#include "MeshSimplifier.h"
+#include "TriangleStripper.h"
 #include "../log/log.h"
 
 using namespace fbxconv::modeldata;
 
 namespace fbxconv {
 namespace readers {
-	struct TextureFileInfo {
-		std::string path;
-		// The uv bounds of this texture that are actually used (x1, y1, x2, y2)
-		float bounds[4];
-		// The number of nodes that use this texture
-		unsigned int nodeCount;
-		// The material textures that reference this texture
-		std::vector<Material::Texture *> textures;
-		TextureFileInfo() : nodeCount(0) {
-			memset(bounds, -1, sizeof(float) * 4);
-		}
-	};
-
-	typedef void (*TextureInfoCallback)(std::map<std::string, TextureFileInfo> &textures);
-
 	bool FbxConverter_ImportCB(void *pArgs, float pPercentage, const char *pStatus);
 
 	class FbxConverter : public Reader {
@@ -58,6 +47,8 @@ namespace readers {
 
 		// Resources (will be disposed)
 		std::vector<FbxMeshInfo *> meshInfos;
+		// The materials which are replaced by an equal material
+		std::vector<Material *> mergedMaterials;
 
 		// Helper maps/lists, resources in those will not be disposed
 		std::map<FbxGeometry *, FbxMeshInfo *> fbxMeshMap;
@@ -65,6 +56,22 @@ namespace readers {
 		std::map<std::string, TextureFileInfo> textureFiles;
 		std::map<FbxMeshInfo *, std::vector<std::vector<MeshPart *> > > meshParts; //[FbxMeshInfo][materialIndex][boneIndex]
 		std::map<const FbxNode *, Node *> nodeMap;
+		// The nodes which are (or whose parents are) animated
+		std::set<const FbxNode *> animatedNodes;
+		// The nodes whose vertices are baked into the static batches
+		std::set<const FbxNode *> batchedNodes;
+		// The current meshpart to add static vertices to, per material and attributes
+		std::map<std::pair<std::pair<const Material *, unsigned long>, std::string>, std::pair<Mesh *, MeshPart *> > staticParts;
+		// All meshparts created for static batching, with the mesh they're in
+		std::vector<std::pair<Mesh *, MeshPart *> > staticPartList;
+		// The node which references the static batches, or 0 if not batching
+		Node *staticNode;
+		// The meshes which can be reused per attributes value
+		std::map<unsigned long, std::vector<Mesh *> > meshBuckets;
+		// The running total of indices of each mesh
+		std::map<const Mesh *, unsigned int> meshIndexCounts;
+		// The blend shape created for each blend shape channel
+		std::map<FbxBlendShapeChannel *, BlendShape *> blendShapes;
 
 		Settings *settings;
 		fbxconv::log::Log *log;
@@ -86,7 +93,7 @@ namespace readers {
 			//const bool &flipV = false
 
 		FbxConverter(fbxconv::log::Log *log, TextureInfoCallback textureCallback) 
-			:	log(log), scene(0), textureCallback(textureCallback) {
+			:	scene(0), staticNode(0), log(log), textureCallback(textureCallback) {
 
 			manager = FbxManager::Create();
 			manager->SetIOSettings(FbxIOSettings::Create(manager, IOSROOT));
@@ -131,10 +138,14 @@ namespace readers {
 				fetchMaterials();
 			if (scene)
 				fetchTextureBounds();
+			if (scene)
+				mergeDuplicateTextures();
 			return !(scene == 0);
 		}
 
 		virtual ~FbxConverter() {
+			for (std::vector<Material *>::iterator itr = mergedMaterials.begin(); itr != mergedMaterials.end(); ++itr)
+				delete (*itr);
 			for (std::vector<FbxMeshInfo *>::iterator itr = meshInfos.begin(); itr != meshInfos.end(); ++itr)
 				delete (*itr);
 			manager->Destroy();
@@ -165,7 +176,7 @@ namespace readers {
 				return false;
 			}
 			if (textureCallback)
-				textureCallback(textureFiles);
+				textureCallback(textureFiles, settings, log);
 			for (int i = 0; i < 8; i++) {
 				uvTransforms[i].idt();
 				if (settings->flipV)
@@ -173,14 +184,32 @@ namespace readers {
 			}
 
 			for (std::map<FbxSurfaceMaterial *, Material *>::iterator it = materialsMap.begin(); it != materialsMap.end(); ++it) {
-				model->materials.push_back(it->second);
 				for (std::vector<Material::Texture *>::iterator tt = it->second->textures.begin(); tt != it->second->textures.end(); ++tt)
 					(*tt)->path = textureFiles[(*tt)->path].path;
+				if (settings->mergeMaterials) {
+					Material *equal = findEqualMaterial(model, it->second);
+					if (equal) {
+						mergedMaterials.push_back(it->second);
+						it->second = equal;
+						continue;
+					}
+				}
+				model->materials.push_back(it->second);
+			}
+			if (!mergedMaterials.empty())
+				log->verbose(log::iSourceConvertMergedMaterials, (int)mergedMaterials.size(), (int)model->materials.size());
+			if (settings->staticBatching) {
+				fetchAnimatedNodes();
+				staticNode = new Node("static_batch");
 			}
 			addMesh(model);
 			addNode(model);
 			for (std::vector<Node *>::iterator itr = model->nodes.begin(); itr != model->nodes.end(); ++itr)
 				updateNode(model, *itr);
+			if (staticNode)
+				addStaticNode(model);
+			if (settings->skeleton)
+				model->skeleton.build(model->nodes);
 			addAnimations(model, scene);
 			return true;
 		}
@@ -216,7 +245,7 @@ namespace readers {
 			set<4>(node->transform.rotation, m.GetQ().mData);
 			set<3>(node->transform.scale, m.GetS().mData);
 
-			if (fbxMeshMap.find(node->source->GetGeometry()) != fbxMeshMap.end()) {
+			if (batchedNodes.find(node->source) == batchedNodes.end() && fbxMeshMap.find(node->source->GetGeometry()) != fbxMeshMap.end()) {
 				FbxMeshInfo *meshInfo = fbxMeshMap[node->source->GetGeometry()];
 				std::vector<std::vector<MeshPart *> > &parts = meshParts[meshInfo];
 				const int matCount = node->source->GetMaterialCount();
@@ -230,9 +259,16 @@ namespace readers {
 							nodePart->meshPart = parts[i][j];
 							for (int k = 0; k < nodePart->meshPart->sourceBones.size(); k++) {
 								if (nodeMap.find(nodePart->meshPart->sourceBones[k]->GetLink()) != nodeMap.end()) {
-									std::pair<Node*, FbxAMatrix> p;
+									std::pair<Node*, BindPose> p;
 									p.first = nodeMap[nodePart->meshPart->sourceBones[k]->GetLink()];
-									getBindPose(node->source, nodePart->meshPart->sourceBones[k], p.second);
+									FbxAMatrix bindPose;
+									getBindPose(node->source, nodePart->meshPart->sourceBones[k], bindPose);
+									set<4>(p.second.translation, bindPose.GetT().mData);
+									set<4>(p.second.rotation, bindPose.GetQ().mData);
+									set<4>(p.second.scale, bindPose.GetS().mData);
+									const FbxAMatrix inverse = bindPose.Inverse();
+									for (int i = 0; i < 16; i++)
+										p.second.inverse[i] = (float)inverse.Get(i >> 2, i & 3);
 									nodePart->bones.push_back(p);
 								}
 								else {
@@ -240,23 +276,59 @@ namespace readers {
 								}
 							}
 
-							nodePart->uvMapping.resize(meshInfo->uvCount);
-							for (unsigned int k = 0; k < meshInfo->uvCount; k++) {
-								for (std::vector<Material::Texture *>::iterator it = material->textures.begin(); it != material->textures.end(); ++it) {
-									FbxFileTexture *texture = (*it)->source;
-									TextureFileInfo &info = textureFiles[texture->GetFileName()];
-									if (meshInfo->uvMapping[k] == texture->UVSet.Get().Buffer()) {
-										nodePart->uvMapping[k].push_back(*it);
-									}
-								}
-							}
+							setUVMapping(nodePart, material, meshInfo);
 						}
 					}
 				}
 			}
 
-			for (std::vector<Node *>::iterator itr = node->children.begin(); itr != node->children.end(); ++itr)
+			for (std::vector<NodePart *>::const_iterator itr = node->parts.begin(); itr != node->parts.end(); ++itr)
+				node->bounds.ext((*itr)->meshPart->bounds);
+
+			for (std::vector<Node *>::iterator itr = node->children.begin(); itr != node->children.end(); ++itr) {
 				updateNode(model, *itr);
+				node->bounds.ext((*itr)->bounds, (*itr)->transform.translation, (*itr)->transform.rotation, (*itr)->transform.scale);
+			}
+		}
+
+		void setUVMapping(NodePart * const &nodePart, Material * const &material, const FbxMeshInfo * const &meshInfo) {
+			nodePart->uvMapping.resize(meshInfo->uvCount);
+			for (unsigned int k = 0; k < meshInfo->uvCount; k++) {
+				for (std::vector<Material::Texture *>::iterator it = material->textures.begin(); it != material->textures.end(); ++it) {
+					FbxFileTexture *texture = (*it)->source;
+					if (meshInfo->uvMapping[k] == texture->UVSet.Get().Buffer()) {
+						nodePart->uvMapping[k].push_back(*it);
+					}
+				}
+			}
+		}
+
+		/** Add the node referencing the static batches to the model, or dispose it if there aren't any. */
+		void addStaticNode(Model * const &model) {
+			for (std::vector<std::pair<Mesh *, MeshPart *> >::iterator itr = staticPartList.begin(); itr != staticPartList.end(); ++itr) {
+				if (itr->first->attributes.hasPosition())
+					calcBoundingSphere(itr->first, itr->second);
+				if (!settings->lodRatios.empty())
+					addLods(itr->first, itr->second);
+				staticNode->bounds.ext(itr->second->bounds);
+				if (settings->triangleStrips)
+					TriangleStripper::stripify(itr->second);
+			}
+			if (meshListener) {
+				std::set<Mesh *> completed;
+				for (std::vector<std::pair<Mesh *, MeshPart *> >::iterator itr = staticPartList.begin(); itr != staticPartList.end(); ++itr)
+					if (completed.insert(itr->first).second)
+						meshListener->meshCompleted(itr->first);
+			}
+			if (staticNode->parts.empty())
+				delete staticNode;
+			else {
+				while (model->getNode(staticNode->id.c_str()))
+					staticNode->id += "_";
+				model->nodes.push_back(staticNode);
+				log->verbose(log::iSourceConvertStaticBatch, (int)batchedNodes.size(), (int)staticNode->parts.size());
+			}
+			staticNode = 0;
 		}
 
 		FbxAMatrix convertMatrix(const FbxMatrix& mat)
@@ -307,8 +379,12 @@ namespace readers {
 
 			FbxGeometry *geometry = node->GetGeometry();
 			if (geometry) {
-				if (fbxMeshMap.find(geometry) != fbxMeshMap.end())
-					addMesh(model, fbxMeshMap[geometry], node);
+				if (fbxMeshMap.find(geometry) != fbxMeshMap.end()) {
+					if (staticNode && isStatic(node, fbxMeshMap[geometry]))
+						addStaticMesh(model, fbxMeshMap[geometry], node);
+					else
+						addMesh(model, fbxMeshMap[geometry], node);
+				}
 				else
 					log->debug("Geometry(%X) of %s not found in fbxMeshMap[size=%d]", (unsigned long)(geometry), node->GetName(), fbxMeshMap.size());
 			}
@@ -319,13 +395,16 @@ namespace readers {
 			if (meshParts.find(meshInfo) != meshParts.end())
 				return;
 
-			Mesh *mesh = findReusableMesh(model, meshInfo->attributes, meshInfo->polyCount * 3);
-			if (mesh == 0) {
-				mesh = new Mesh();
-				model->meshes.push_back(mesh);
-				mesh->attributes = meshInfo->attributes;
-				mesh->vertexSize = mesh->attributes.size();
-			}
+			// Reserve room for the levels of detail as well, which only add indices
+			float lodRatio = 1.f;
+			for (std::vector<float>::const_iterator itr = settings->lodRatios.begin(); itr != settings->lodRatios.end(); ++itr)
+				lodRatio += *itr;
+			// The blend shapes reference the vertices of the mesh, so a mesh with blend shapes doesn't reuse another mesh and
+			// isn't reused itself (which could share its vertices with other geometry)
+			const bool shapes = hasBlendShapes(meshInfo);
+			Mesh *mesh = shapes ? 0 : findReusableMesh(meshInfo->attributes, meshInfo->polyCount * 3, (unsigned int)(lodRatio * meshInfo->polyCount * 3));
+			if (mesh == 0)
+				mesh = createMesh(model, meshInfo->attributes, !shapes);
 
 			std::vector<std::vector<MeshPart *> > &parts = meshParts[meshInfo];
 			parts.resize(meshInfo->meshPartCount);
@@ -345,6 +424,9 @@ namespace readers {
 			}
 
 			float *vertex = new float[mesh->vertexSize];
+			const bool hasPosition = mesh->attributes.hasPosition();
+			// The polygon vertex and control point each vertex is created of, to look up its values in the blend shapes
+			std::vector<std::pair<unsigned int, unsigned int> > vertexSources;
 			unsigned int pidx = 0;
 			for (unsigned int poly = 0; poly < meshInfo->polyCount; poly++) {
 				unsigned int ps = meshInfo->mesh->GetPolygonSize(poly);
@@ -354,10 +436,17 @@ namespace readers {
 				for (unsigned int i = 0; i < ps; i++) {
 					const unsigned int v = meshInfo->mesh->GetPolygonVertex(poly, i);
 					meshInfo->getVertex(vertex, poly, pidx, v, uvTransforms);
-					part->indices.push_back(mesh->add(vertex));
+					const unsigned int index = mesh->add(vertex);
+					part->indices.push_back(index);
+					if (shapes && index == vertexSources.size())
+						vertexSources.push_back(std::make_pair(pidx, v));
+					if (hasPosition)
+						part->bounds.ext(vertex);
 					pidx++;
 				}
 			}
+			if (shapes)
+				addBlendShapes(mesh, meshInfo, vertexSources);
 
 			int idx = 0;
 			for (int i = parts.size() - 1; i >= 0; --i) {
@@ -373,20 +462,302 @@ namespace readers {
 						std::stringstream ss;
 						ss << meshInfo->id.c_str() << "_part" << (++idx);
 						part->id = ss.str();
+						meshIndexCounts[mesh] += (unsigned int)part->indices.size();
+						if (hasPosition)
+							calcBoundingSphere(mesh, part);
 					}
 				}
 			}
 
+			if (!settings->lodRatios.empty())
+				for (unsigned int i = 0; i < parts.size(); i++)
+					for (unsigned int j = 0; j < parts[i].size(); j++)
+						if (parts[i][j])
+							addLods(mesh, parts[i][j]);
+
+			// The levels of detail are generated from the triangle lists, so convert the parts afterwards
+			if (settings->triangleStrips)
+				for (unsigned int i = 0; i < parts.size(); i++)
+					for (unsigned int j = 0; j < parts[i].size(); j++)
+						if (parts[i][j])
+							TriangleStripper::stripify(parts[i][j]);
+
 			delete[] vertex;
+			if (meshListener)
+				meshListener->meshCompleted(mesh);
 		}
 
-		Mesh *findReusableMesh(Model * const &model, const Attributes &attributes, const unsigned int &vertexCount) {
-			for (std::vector<Mesh *>::iterator itr = model->meshes.begin(); itr != model->meshes.end(); ++itr)
-				if ((*itr)->attributes == attributes && 
-					((*itr)->vertices.size() / (*itr)->vertexSize) + vertexCount <= settings->maxVertexCount && 
-					(*itr)->indexCount() + vertexCount <= settings->maxIndexCount)
-					return (*itr);
-			return 0;
+		/** Add the blend shape channels of the mesh info as blend shapes of the mesh, listing the vertices which differ from
+		 * the mesh at the full weight of the channel. Each vertex takes the difference of the polygon vertex it was created of,
+		 * so a vertex welded from several control points gets the difference of the first of them. */
+		void addBlendShapes(Mesh * const &mesh, FbxMeshInfo * const &meshInfo, const std::vector<std::pair<unsigned int, unsigned int> > &vertexSources) {
+			const bool hasNormal = mesh->attributes.hasNormal();
+			const int deformerCount = meshInfo->mesh->GetDeformerCount(FbxDeformer::eBlendShape);
+			FbxVector4 normal, shapeNormal;
+			float position[3], normalDelta[3];
+			for (int d = 0; d < deformerCount; d++) {
+				FbxBlendShape *deformer = static_cast<FbxBlendShape *>(meshInfo->mesh->GetDeformer(d, FbxDeformer::eBlendShape));
+				const int channelCount = deformer->GetBlendShapeChannelCount();
+				for (int c = 0; c < channelCount; c++) {
+					FbxBlendShapeChannel *channel = deformer->GetBlendShapeChannel(c);
+					const int targetCount = channel->GetTargetShapeCount();
+					if (targetCount < 1)
+						continue;
+					// The last target is the shape at full weight
+					if (targetCount > 1)
+						log->warning(log::wSourceConvertFbxInBetweenShapes, meshInfo->id.c_str(), channel->GetName());
+					FbxShape *shape = channel->GetTargetShape(targetCount - 1);
+					if (shape == 0 || shape->GetControlPointsCount() != (int)meshInfo->pointCount)
+						continue;
+					const FbxVector4 * const points = shape->GetControlPoints();
+					const FbxGeometryElementNormal * const normals = hasNormal ? shape->GetElementNormal() : 0;
+					const bool normalOnPoint = normals && normals->GetMappingMode() == FbxGeometryElement::eByControlPoint;
+					const bool useNormals = normalOnPoint || (normals && normals->GetMappingMode() == FbxGeometryElement::eByPolygonVertex);
+
+					BlendShape *blendShape = new BlendShape();
+					blendShape->id = meshInfo->id + "_" + channel->GetName();
+					for (unsigned int i = 0; i < (unsigned int)vertexSources.size(); i++) {
+						const unsigned int &polyIndex = vertexSources[i].first, &point = vertexSources[i].second;
+						for (int k = 0; k < 3; k++)
+							position[k] = (float)(points[point][k] - meshInfo->points[point][k]);
+						bool changed = !cmp(position[0], 0.f) || !cmp(position[1], 0.f) || !cmp(position[2], 0.f);
+						if (useNormals) {
+							meshInfo->getNormal(&normal, polyIndex, point);
+							int index = normalOnPoint ? (int)point : (int)polyIndex;
+							if (normals->GetReferenceMode() != FbxGeometryElement::eDirect)
+								index = normals->GetIndexArray().GetAt(index);
+							shapeNormal = normals->GetDirectArray().GetAt(index);
+							for (int k = 0; k < 3; k++)
+								normalDelta[k] = (float)(shapeNormal[k] - normal[k]);
+							changed = changed || !cmp(normalDelta[0], 0.f) || !cmp(normalDelta[1], 0.f) || !cmp(normalDelta[2], 0.f);
+						}
+						if (!changed)
+							continue;
+						blendShape->indices.push_back((unsigned short)i);
+						blendShape->positions.insert(blendShape->positions.end(), position, position + 3);
+						if (useNormals)
+							blendShape->normals.insert(blendShape->normals.end(), normalDelta, normalDelta + 3);
+					}
+					if (blendShape->indices.empty()) {
+						delete blendShape;
+						continue;
+					}
+					mesh->blendShapes.push_back(blendShape);
+					blendShapes[channel] = blendShape;
+				}
+			}
+		}
+
+		void addLods(Mesh * const &mesh, MeshPart * const &part) {
+			// Vertices shared with other parts can't be moved, otherwise the other part would tear.
+			std::vector<bool> locked(mesh->vertices.size() / mesh->vertexSize, false);
+			for (std::vector<MeshPart *>::const_iterator itr = mesh->parts.begin(); itr != mesh->parts.end(); ++itr)
+				if ((*itr) != part)
+					for (std::vector<unsigned short>::const_iterator it = (*itr)->indices.begin(); it != (*itr)->indices.end(); ++it)
+						locked[*it] = true;
+
+			MeshSimplifier simplifier(mesh, part->indices, locked);
+			const unsigned int triangleCount = part->indices.size() / 3;
+			unsigned int previousCount = simplifier.triangleCount();
+			for (std::vector<float>::const_iterator itr = settings->lodRatios.begin(); itr != settings->lodRatios.end(); ++itr) {
+				simplifier.simplify((unsigned int)((*itr) * triangleCount));
+				if (simplifier.triangleCount() == 0 || simplifier.triangleCount() >= previousCount)
+					break;
+				previousCount = simplifier.triangleCount();
+				MeshPart *lod = new MeshPart();
+				lod->primitiveType = part->primitiveType;
+				lod->sourceBones = part->sourceBones;
+				lod->bounds = part->bounds;
+				simplifier.getIndices(lod->indices);
+				std::stringstream ss;
+				ss << part->id.c_str() << "_lod" << (part->lods.size() + 1);
+				lod->id = ss.str();
+				part->lods.push_back(lod);
+				mesh->parts.push_back(lod);
+				meshIndexCounts[mesh] += (unsigned int)lod->indices.size();
+				log->verbose(log::iSourceConvertLod, part->id.c_str(), (int)part->lods.size(), (int)previousCount, (int)triangleCount);
+			}
+		}
+
+		/** Create a mesh with the specified attributes, only a reusable mesh is considered by findReusableMesh */
+		Mesh *createMesh(Model * const &model, const Attributes &attributes, const bool &reusable = true) {
+			Mesh *mesh = new Mesh();
+			model->meshes.push_back(mesh);
+			mesh->attributes = attributes;
+			mesh->vertexSize = mesh->attributes.size();
+			if (settings->weldVertices)
+				mesh->setWeldTolerance(WeldTolerance(settings->weldPosition, settings->weldNormalAngle, settings->weldUV, settings->weldColor));
+			if (reusable)
+				meshBuckets[attributes.value].push_back(mesh);
+			meshIndexCounts[mesh] = 0;
+			return mesh;
+		}
+
+		/** Whether the vertices of the node can be baked into the static batches */
+		bool isStatic(FbxNode * const &node, const FbxMeshInfo * const &meshInfo) const {
+			return meshInfo->skin == 0 && !hasBlendShapes(meshInfo) && animatedNodes.find(node) == animatedNodes.end();
+		}
+
+		inline bool hasBlendShapes(const FbxMeshInfo * const &meshInfo) const {
+			return settings->blendShapes && meshInfo->mesh->GetDeformerCount(FbxDeformer::eBlendShape) > 0;
+		}
+
+		/** Add the polygons of the node, transformed to world space, to the static meshpart of their material */
+		void addStaticMesh(Model * const &model, FbxMeshInfo * const &meshInfo, FbxNode * const &node) {
+			batchedNodes.insert(node);
+			const FbxAMatrix transform = node->EvaluateGlobalTransform() * GetGeometry(node);
+			const FbxAMatrix normalTransform = transform.Inverse().Transpose();
+			// A mirroring transform would flip the winding of the triangles
+			const bool flip = transform.Determinant() < 0.;
+			const Attributes &attributes = meshInfo->attributes;
+			const int positionOffset = attributes.getOffset(ATTRIBUTE_POSITION);
+			const int normalOffset = attributes.getOffset(ATTRIBUTE_NORMAL);
+			const int tangentOffset = attributes.getOffset(ATTRIBUTE_TANGENT);
+			const int binormalOffset = attributes.getOffset(ATTRIBUTE_BINORMAL);
+			const int matCount = node->GetMaterialCount();
+
+			float *vertex = new float[attributes.size()];
+			unsigned short polyIndices[64];
+			unsigned int pidx = 0;
+			for (unsigned int poly = 0; poly < meshInfo->polyCount; poly++) {
+				const unsigned int ps = meshInfo->mesh->GetPolygonSize(poly);
+				const int matIndex = (int)meshInfo->polyPartMap[poly];
+				if (matIndex < 0 || matIndex >= matCount || ps > 64) {
+					pidx += ps;
+					continue;
+				}
+				std::pair<Mesh *, MeshPart *> &batch = getStaticPart(model, materialsMap[node->GetMaterial(matIndex)], meshInfo, ps);
+				for (unsigned int i = 0; i < ps; i++) {
+					const unsigned int v = meshInfo->mesh->GetPolygonVertex(poly, i);
+					meshInfo->getVertex(vertex, poly, pidx, v, uvTransforms);
+					if (positionOffset >= 0)
+						transformVector(transform, vertex + positionOffset, 1.);
+					if (normalOffset >= 0)
+						transformVector(normalTransform, vertex + normalOffset, 0., true);
+					if (tangentOffset >= 0)
+						transformVector(transform, vertex + tangentOffset, 0., true);
+					if (binormalOffset >= 0)
+						transformVector(transform, vertex + binormalOffset, 0., true);
+					polyIndices[flip ? ps - 1 - i : i] = batch.first->add(vertex);
+					if (positionOffset >= 0)
+						batch.second->bounds.ext(vertex + positionOffset);
+					pidx++;
+				}
+				batch.second->indices.insert(batch.second->indices.end(), polyIndices, polyIndices + ps);
+				meshIndexCounts[batch.first] += ps;
+			}
+			delete[] vertex;
+		}
+
+		static void transformVector(const FbxAMatrix &matrix, float * const &v, const double &w, const bool &normalize = false) {
+			FbxVector4 r = matrix.MultT(FbxVector4(v[0], v[1], v[2], w));
+			if (normalize) {
+				const double l = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+				if (l > 0.)
+					r = FbxVector4(r[0] / l, r[1] / l, r[2] / l, 0.);
+			}
+			v[0] = (float)r[0];
+			v[1] = (float)r[1];
+			v[2] = (float)r[2];
+		}
+
+		/** Get the static meshpart of the material which has room for at least the specified amount of vertices and indices */
+		std::pair<Mesh *, MeshPart *> &getStaticPart(Model * const &model, Material * const &material, FbxMeshInfo * const &meshInfo, const unsigned int &count) {
+			// The uv sets are part of the key, so the uv mapping of the batch is valid for all meshes added to it
+			std::string uvSets;
+			for (unsigned int i = 0; i < meshInfo->uvCount; i++)
+				uvSets.append(meshInfo->uvMapping[i]).append(1, '\0');
+			std::pair<Mesh *, MeshPart *> &result = staticParts[std::make_pair(std::make_pair((const Material *)material, meshInfo->attributes.value), uvSets)];
+			if (result.second != 0 &&
+				(result.first->vertices.size() / result.first->vertexSize) + count <= (unsigned int)settings->maxVertexCount &&
+				meshIndexCounts[result.first] + count <= (unsigned int)settings->maxIndexCount)
+				return result;
+			result.first = findReusableMesh(meshInfo->attributes, count, count);
+			if (result.first == 0)
+				result.first = createMesh(model, meshInfo->attributes);
+			result.second = new MeshPart();
+			result.second->primitiveType = PRIMITIVETYPE_TRIANGLES;
+			std::stringstream ss;
+			ss << "static_" << material->id.c_str() << "_part" << (staticPartList.size() + 1);
+			result.second->id = ss.str();
+			result.first->parts.push_back(result.second);
+			staticPartList.push_back(result);
+
+			NodePart *nodePart = new NodePart();
+			nodePart->material = material;
+			nodePart->meshPart = result.second;
+			setUVMapping(nodePart, material, meshInfo);
+			staticNode->parts.push_back(nodePart);
+			return result;
+		}
+
+		/** Collect the nodes which are animated or are a child of an animated node */
+		void fetchAnimatedNodes() {
+			animatedNodes.clear();
+			const int animCount = scene->GetSrcObjectCount<FbxAnimStack>();
+			for (int i = 0; i < animCount; i++) {
+				FbxAnimStack *animStack = scene->GetSrcObject<FbxAnimStack>(i);
+				const int layerCount = animStack->GetMemberCount<FbxAnimLayer>();
+				for (int l = 0; l < layerCount; l++) {
+					FbxAnimLayer *layer = animStack->GetMember<FbxAnimLayer>(l);
+					const int curveNodeCount = layer->GetSrcObjectCount<FbxAnimCurveNode>();
+					for (int n = 0; n < curveNodeCount; n++) {
+						FbxAnimCurveNode *curveNode = layer->GetSrcObject<FbxAnimCurveNode>(n);
+						const int nc = curveNode->GetDstPropertyCount();
+						for (int o = 0; o < nc; o++) {
+							FbxProperty prop = curveNode->GetDstProperty(o);
+							FbxNode *node = static_cast<FbxNode *>(prop.GetFbxObject());
+							if (!node)
+								continue;
+							FbxString propName = prop.GetName();
+							if ((node->LclTranslation.IsValid() && propName == node->LclTranslation.GetName()) ||
+								(node->LclRotation.IsValid() && propName == node->LclRotation.GetName()) ||
+								(node->LclScaling.IsValid() && propName == node->LclScaling.GetName()))
+								addAnimatedNode(node);
+						}
+					}
+				}
+			}
+		}
+
+		void addAnimatedNode(FbxNode * const &node) {
+			if (!animatedNodes.insert(node).second)
+				return;
+			for (int i = 0; i < node->GetChildCount(); i++)
+				addAnimatedNode(node->GetChild(i));
+		}
+
+		// The position is always the first attribute, note that the vertices might be welded to a nearby position
+		void calcBoundingSphere(const Mesh * const &mesh, MeshPart * const &part) {
+			part->bounds.calcSphere();
+			for (std::vector<unsigned short>::const_iterator itr = part->indices.begin(); itr != part->indices.end(); ++itr) {
+				const float * const position = &mesh->vertices[(*itr) * mesh->vertexSize];
+				part->bounds.ext(position);
+				part->bounds.extSphere(position);
+			}
+		}
+
+		/** Find the mesh with the same attributes which has the least room left after adding the vertices and indices (best fit), 
+		 * or 0 if no mesh has enough room left. */
+		Mesh *findReusableMesh(const Attributes &attributes, const unsigned int &vertexCount, const unsigned int &indexCount) {
+			std::map<unsigned long, std::vector<Mesh *> >::const_iterator bucket = meshBuckets.find(attributes.value);
+			// Completed meshes might already be written and released
+			if (meshListener || bucket == meshBuckets.end())
+				return 0;
+			Mesh *result = 0;
+			unsigned int best = 0;
+			for (std::vector<Mesh *>::const_iterator itr = bucket->second.begin(); itr != bucket->second.end(); ++itr) {
+				const unsigned int vertices = (unsigned int)((*itr)->vertices.size() / (*itr)->vertexSize) + vertexCount;
+				const unsigned int indices = meshIndexCounts[*itr] + indexCount;
+				if (vertices > (unsigned int)settings->maxVertexCount || indices > (unsigned int)settings->maxIndexCount)
+					continue;
+				const unsigned int left = std::min(settings->maxVertexCount - vertices, settings->maxIndexCount - indices);
+				if (result == 0 || left < best) {
+					result = *itr;
+					best = left;
+				}
+			}
+			return result;
 		}
 
 		void fetchTextureBounds(FbxNode *node = 0) {
@@ -426,6 +797,52 @@ namespace readers {
 			}
 		}
 
+		/** Merge the textures whose files have the same content, the material textures of the duplicates are updated to
+		 * reference the remaining one. */
+		void mergeDuplicateTextures() {
+			const std::string directory = TextureFileInfo::getDirectory(settings->inFile);
+			// [hash, size] => [texture, filename], the content is compared as well, because the hash might collide
+			std::map<std::pair<unsigned long long, unsigned long long>, std::vector<std::pair<std::string, std::string> > > files;
+			std::vector<std::string> duplicates;
+			unsigned long long saved = 0;
+			for (std::map<std::string, TextureFileInfo>::iterator itr = textureFiles.begin(); itr != textureFiles.end(); ++itr) {
+				std::pair<unsigned long long, unsigned long long> key;
+				const std::string filename = TextureFileInfo::locate(itr->first, directory);
+				if (filename.empty() || !TextureFileInfo::hashFile(filename, key.first, key.second))
+					continue;
+				std::vector<std::pair<std::string, std::string> > &candidates = files[key];
+				std::vector<std::pair<std::string, std::string> >::const_iterator it = candidates.begin();
+				while (it != candidates.end() && !TextureFileInfo::equalFiles(it->second, filename))
+					++it;
+				if (it == candidates.end()) {
+					candidates.push_back(std::make_pair(itr->first, filename));
+					continue;
+				}
+				TextureFileInfo &info = textureFiles[it->first];
+				for (std::vector<Material::Texture *>::iterator tt = itr->second.textures.begin(); tt != itr->second.textures.end(); ++tt) {
+					(*tt)->path = it->first;
+					info.textures.push_back(*tt);
+				}
+				if (itr->second.hasBounds()) {
+					if (!info.hasBounds())
+						memcpy(info.bounds, itr->second.bounds, sizeof(float) * 4);
+					else {
+						info.bounds[0] = std::min(info.bounds[0], itr->second.bounds[0]);
+						info.bounds[1] = std::min(info.bounds[1], itr->second.bounds[1]);
+						info.bounds[2] = std::max(info.bounds[2], itr->second.bounds[2]);
+						info.bounds[3] = std::max(info.bounds[3], itr->second.bounds[3]);
+					}
+				}
+				info.nodeCount += itr->second.nodeCount;
+				duplicates.push_back(itr->first);
+				saved += key.second;
+			}
+			for (std::vector<std::string>::const_iterator itr = duplicates.begin(); itr != duplicates.end(); ++itr)
+				textureFiles.erase(*itr);
+			if (!duplicates.empty())
+				log->info(log::iSourceLoadDuplicateTextures, (int)duplicates.size(), (double)saved / 1024.);
+		}
+
 		const char *getGeometryName(const FbxGeometry * const &g) {
 			static char buff[512];
 			const char *name = g->GetName();
@@ -494,6 +911,13 @@ namespace readers {
 			}
 		}
 
+		Material *findEqualMaterial(Model * const &model, const Material * const &material) {
+			for (std::vector<Material *>::iterator itr = model->materials.begin(); itr != model->materials.end(); ++itr)
+				if ((*itr)->equals(*material))
+					return *itr;
+			return 0;
+		}
+
 		void fetchMaterials() {
 			int cnt = scene->GetMaterialCount();
 			for (int i = 0; i < cnt; i++) {
@@ -572,6 +996,7 @@ namespace readers {
 				return 0;
 			Material::Texture * const result = new Material::Texture();
 			result->source = texture;
+			result->uvSet = texture->UVSet.Get().Buffer();
 			result->id = texture->GetName();
 			result->path = texture->GetFileName();
 			set<2>(result->uvTranslation, texture->GetUVTranslation().mData);
@@ -583,24 +1008,48 @@ namespace readers {
 			return result;
 		}
 
-		/** Add the animations if any */
+		/** Add the animations if any, each animation stack is split into the clips of its take (if any) */
 		void addAnimations(Model * const &model, const FbxScene * const &source) {
 			const unsigned int animCount = source->GetSrcObjectCount<FbxAnimStack>();
-			for (unsigned int i = 0; i < animCount; i++)
-				addAnimation(model, source->GetSrcObject<FbxAnimStack>(i));
+			std::vector<bool> used(settings->clips.size(), false);
+			for (unsigned int i = 0; i < animCount; i++) {
+				FbxAnimStack * const animStack = source->GetSrcObject<FbxAnimStack>(i);
+				bool clipped = false;
+				for (size_t c = 0; c < settings->clips.size(); c++) {
+					const AnimationClip &clip = settings->clips[c];
+					if (!clip.take.empty() && clip.take != animStack->GetName())
+						continue;
+					addAnimation(model, animStack, &clip);
+					used[c] = clipped = true;
+				}
+				if (!clipped)
+					addAnimation(model, animStack);
+			}
+			for (size_t c = 0; c < settings->clips.size(); c++)
+				if (!used[c])
+					log->warning(log::wSourceConvertFbxUnusedClip, settings->clips[c].name.c_str(), settings->clips[c].take.c_str());
 		}
 
-		/** Add the specified animation to the model */
-		void addAnimation(Model *const &model, FbxAnimStack * const &animStack) {
-			static std::vector<Keyframe *> frames;
+		/** Add the specified animation to the model, or only the specified time range of it if a clip is specified */
+		void addAnimation(Model *const &model, FbxAnimStack * const &animStack, const AnimationClip * const &clip = 0) {
+			static std::vector<Keyframe> frames;
+			static std::vector<std::vector<Keyframe> > nodeFrames;
+			static std::vector<float> times, weights;
 			static std::map<FbxNode *, AnimInfo> affectedNodes;
+			static std::map<FbxBlendShapeChannel *, AnimInfo> affectedChannels;
 			affectedNodes.clear();
+			affectedChannels.clear();
+			nodeFrames.clear();
 
 			FbxTimeSpan animTimeSpan = animStack->GetLocalTimeSpan();
 			float animStart = (float)(animTimeSpan.GetStart().GetMilliSeconds());
 			float animStop = (float)(animTimeSpan.GetStop().GetMilliSeconds());
 			if (animStop <= animStart)
 				animStop = 999999999.0f;
+			if (clip) {
+				animStart = clip->start * 1000.f;
+				animStop = clip->stop * 1000.f;
+			}
 
 			// Could also use animStack->GetLocalTimeSpan and animStack->BakeLayers, but its not guaranteed to be correct
 			const int layerCount = animStack->GetMemberCount<FbxAnimLayer>();
@@ -619,8 +1068,17 @@ namespace readers {
 							FbxString propName = prop.GetName();
 							if ( propName == "DeformPercent" )
 							{
-								// When using this propName in model an unhandled exception is launched in sentence node->LclTranslation.GetName()
-								log->warning(log::wSourceConvertFbxSkipPropname, animStack->GetName(), (const char *)propName);
+								// The property belongs to a blend shape channel, not to a node
+								FbxBlendShapeChannel *channel = FbxCast<FbxBlendShapeChannel>(prop.GetFbxObject());
+								FbxAnimCurve *curve;
+								if (channel && blendShapes.find(channel) != blendShapes.end()) {
+									AnimInfo ts;
+									if ((curve = prop.GetCurve(layer)) != 0)
+										updateAnimTime(curve, ts, animStart, animStop);
+									affectedChannels[channel] += ts;
+								}
+								else
+									log->warning(log::wSourceConvertFbxSkipPropname, animStack->GetName(), (const char *)propName);
 								continue;
 							}
 
@@ -647,13 +1105,37 @@ namespace readers {
 				}
 			}
 
-			if (affectedNodes.empty())
+			if (affectedNodes.empty() && affectedChannels.empty())
 				return;
 
+			// A curve might have no keys within the clip, while it still affects the node, so sample the whole clip
+			if (clip) {
+				for (std::map<FbxNode *, AnimInfo>::iterator itr = affectedNodes.begin(); itr != affectedNodes.end(); itr++) {
+					(*itr).second.start = animStart;
+					(*itr).second.stop = animStop;
+				}
+				for (std::map<FbxBlendShapeChannel *, AnimInfo>::iterator itr = affectedChannels.begin(); itr != affectedChannels.end(); itr++) {
+					(*itr).second.start = animStart;
+					(*itr).second.stop = animStop;
+				}
+			}
+
 			Animation *animation = new Animation();
+			animation->id = clip ? clip->name : animStack->GetName();
+			// A clip without a take is taken from every animation stack, prefix the stack to keep the ids unique
+			if (clip && clip->take.empty() && animStack->GetScene()->GetSrcObjectCount<FbxAnimStack>() > 1)
+				animation->id = std::string(animStack->GetName()) + "_" + clip->name;
+			while (model->getAnimation(animation->id.c_str()))
+				animation->id += "_";
 			model->animations.push_back(animation);
-			animation->id = animStack->GetName();
 			animStack->GetScene()->SetCurrentAnimationStack(animStack);
+			animation->tolerance = settings->quantizeAnimations ? settings->animationTolerance : 0.f;
+
+			// With a unified timeline all nodes are sampled within the same time frame and rate
+			AnimInfo timeline;
+			if (settings->unifiedTimeline)
+				for (std::map<FbxNode *, AnimInfo>::const_iterator itr = affectedNodes.begin(); itr != affectedNodes.end(); itr++)
+					timeline += (*itr).second;
 
 			// Add the NodeAnimations to the Animation
 			for (std::map<FbxNode *, AnimInfo>::const_iterator itr = affectedNodes.begin(); itr != affectedNodes.end(); itr++) {
@@ -666,14 +1148,18 @@ namespace readers {
 				nodeAnim->translate = (*itr).second.translate;
 				nodeAnim->rotate = (*itr).second.rotate;
 				nodeAnim->scale = (*itr).second.scale;
-				const float stepSize = (*itr).second.framerate <= 0.f ? (*itr).second.stop - (*itr).second.start : 1000.f / (*itr).second.framerate;
-				const float last = (*itr).second.stop + stepSize * 0.5f;
+				nodeAnim->tracks = settings->keyframeTracks;
+				nodeAnim->tolerance = animation->tolerance;
+				const AnimInfo &info = settings->unifiedTimeline ? timeline : (*itr).second;
+				const float stepSize = info.framerate <= 0.f ? info.stop - info.start : 1000.f / info.framerate;
+				const float last = info.stop + stepSize * 0.5f;
 				FbxTime fbxTime;
 				// Calculate all keyframes upfront
-				for (float time = (*itr).second.start; time <= last; time += stepSize) {
-					time = std::min(time, (*itr).second.stop);
+				for (float time = info.start; time <= last; time += stepSize) {
+					time = std::min(time, info.stop);
 					fbxTime.SetMilliSeconds((FbxLongLong)time);
-					Keyframe *kf = new Keyframe();
+					frames.push_back(Keyframe());
+					Keyframe * const kf = &frames.back();
 					kf->time = (time - animStart);
 					FbxAMatrix *m = &(*itr).first->EvaluateLocalTransform(fbxTime);
 					FbxVector4 v = m->GetT();
@@ -689,15 +1175,52 @@ namespace readers {
 					kf->scale[0] = (float)v.mData[0];
 					kf->scale[1] = (float)v.mData[1];
 					kf->scale[2] = (float)v.mData[2];
-					frames.push_back(kf);
 				}
 				// Only add keyframes really needed
-				addKeyframes(nodeAnim, frames);
-				if (nodeAnim->rotate || nodeAnim->scale || nodeAnim->translate)
+				nodeAnim->frameTime = stepSize;
+				if (settings->unifiedTimeline)
+					updateAnimated(nodeAnim, frames, settings->animationTolerance);
+				else
+					addKeyframes(nodeAnim, frames, settings->animationTolerance);
+				if (nodeAnim->rotate || nodeAnim->scale || nodeAnim->translate) {
 					animation->nodeAnimations.push_back(nodeAnim);
+					if (settings->unifiedTimeline) {
+						nodeFrames.push_back(std::vector<Keyframe>());
+						nodeFrames.back().swap(frames);
+					}
+				}
 				else
 					delete nodeAnim;
 			}
+			if (settings->unifiedTimeline)
+				addKeyframes(animation, nodeFrames, settings->animationTolerance);
+
+			// Add the weights of the blend shapes to the Animation
+			for (std::map<FbxBlendShapeChannel *, AnimInfo>::const_iterator itr = affectedChannels.begin(); itr != affectedChannels.end(); itr++) {
+				if ((*itr).second.stop < (*itr).second.start)
+					continue;
+				times.clear();
+				weights.clear();
+				const float stepSize = (*itr).second.framerate <= 0.f ? (*itr).second.stop - (*itr).second.start : 1000.f / (*itr).second.framerate;
+				const float last = (*itr).second.stop + stepSize * 0.5f;
+				bool used = false;
+				FbxTime fbxTime;
+				for (float time = (*itr).second.start; time <= last; time += stepSize) {
+					time = std::min(time, (*itr).second.stop);
+					fbxTime.SetMilliSeconds((FbxLongLong)time);
+					times.push_back(time - animStart);
+					weights.push_back((float)((*itr).first->DeformPercent.EvaluateValue(fbxTime) / 100.0));
+					used = used || !cmp(weights.back(), 0.f, settings->animationTolerance);
+					if (stepSize <= 0.f)
+						break;
+				}
+				if (!used)
+					continue;
+				BlendShapeAnimation *shapeAnim = new BlendShapeAnimation();
+				shapeAnim->shape = blendShapes[(*itr).first];
+				addWeights(shapeAnim, times, weights, settings->animationTolerance);
+				animation->blendShapeAnimations.push_back(shapeAnim);
+			}
 		}
 
 		inline void updateAnimTime(FbxAnimCurve *const &curve, AnimInfo &ts, const float &animStart, const float &animStop) {
@@ -711,46 +1234,103 @@ namespace readers {
 			ts.framerate = std::max(ts.framerate, (float)stop.GetFrameRate(FbxTime::eDefaultMode));
 		}
 
-		void addKeyframes(NodeAnimation *const &anim, std::vector<Keyframe *> &keyframes) {
+		/** Add the keyframes which can't be interpolated from their neighbours within the tolerance */
+		void addKeyframes(NodeAnimation *const &anim, const std::vector<Keyframe> &keyframes, const float &tolerance = 0.000001f) {
+			updateAnimated(anim, keyframes, tolerance);
+
+			if (!keyframes.empty()) {
+				anim->addKeyframe(keyframes[0]);
+				const int last = (int)keyframes.size()-1;
+				const Keyframe *k1 = &keyframes[0], *k2, *k3;
+				for (int i = 1; i < last; i++) {
+					k2 = &keyframes[i];
+					k3 = &keyframes[i+1];
+					// Check if the middle keyframe can be calculated by information, if so dont add it
+					if (!isLerp(anim, *k1, *k2, *k3, tolerance)) {
+						anim->addKeyframe(*k2);
+						k1 = k2;
+					}
+				}
+				if (last > 0)
+					anim->addKeyframe(keyframes[last]);
+			}
+		}
+
+		/** Add the keyframes to the node animations of the animation on a single timeline: a keyframe is added to every
+		 * node animation if any of them can't interpolate it from its neighbours within the tolerance. The keyframes of each
+		 * node animation (in the same order) must be sampled at the same times. */
+		void addKeyframes(Animation *const &animation, const std::vector<std::vector<Keyframe> > &keyframes, const float &tolerance = 0.000001f) {
+			if (keyframes.empty() || keyframes[0].empty())
+				return;
+			const size_t count = animation->nodeAnimations.size();
+			const int last = (int)keyframes[0].size()-1;
+			std::vector<int> indices;
+			indices.push_back(0);
+			for (int i = 1; i < last; i++) {
+				for (size_t n = 0; n < count; n++) {
+					const std::vector<Keyframe> &frames = keyframes[n];
+					if (!isLerp(animation->nodeAnimations[n], frames[indices.back()], frames[i], frames[i+1], tolerance)) {
+						indices.push_back(i);
+						break;
+					}
+				}
+			}
+			if (last > 0)
+				indices.push_back(last);
+			for (size_t n = 0; n < count; n++) {
+				NodeAnimation * const &anim = animation->nodeAnimations[n];
+				for (std::vector<int>::const_iterator itr = indices.begin(); itr != indices.end(); ++itr)
+					anim->addKeyframe(keyframes[n][*itr]);
+				anim->sharedKeytimes = true;
+			}
+			animation->keytimes = animation->nodeAnimations[0]->keytimes;
+			animation->frameTime = animation->nodeAnimations[0]->frameTime;
+		}
+
+		/** Add the weights which can't be interpolated from their neighbours within the tolerance */
+		void addWeights(BlendShapeAnimation *const &anim, const std::vector<float> &times, const std::vector<float> &weights, const float &tolerance) {
+			if (times.empty())
+				return;
+			anim->keytimes.push_back(times[0]);
+			anim->weights.push_back(weights[0]);
+			const int last = (int)times.size()-1;
+			int k1 = 0;
+			for (int i = 1; i < last; i++) {
+				if (!isLerp(&weights[k1], times[k1], &weights[i], times[i], &weights[i+1], times[i+1], 1, tolerance)) {
+					anim->keytimes.push_back(times[i]);
+					anim->weights.push_back(weights[i]);
+					k1 = i;
+				}
+			}
+			if (last > 0) {
+				anim->keytimes.push_back(times[last]);
+				anim->weights.push_back(weights[last]);
+			}
+		}
+
+		/** Set which components (translation, rotation, scale) of the node are actually changed by the keyframes */
+		void updateAnimated(NodeAnimation *const &anim, const std::vector<Keyframe> &keyframes, const float &tolerance) {
 			bool translate = false, rotate = false, scale = false;
 			// Check which components are actually changed
-			for (std::vector<Keyframe *>::const_iterator itr = keyframes.begin(); itr != keyframes.end(); ++itr) {
-				if (!translate && !cmp(anim->node->transform.translation, (*itr)->translation, 3))
+			for (std::vector<Keyframe>::const_iterator itr = keyframes.begin(); itr != keyframes.end(); ++itr) {
+				if (!translate && !cmp(anim->node->transform.translation, itr->translation, 3, tolerance))
 					translate = true;
-				if (!rotate && !cmp(anim->node->transform.rotation, (*itr)->rotation, 3))
+				if (!rotate && !cmp(anim->node->transform.rotation, itr->rotation, 3, tolerance))
 					rotate = true;
-				if (!scale && !cmp(anim->node->transform.scale, (*itr)->scale, 3))
+				if (!scale && !cmp(anim->node->transform.scale, itr->scale, 3, tolerance))
 					scale = true;
 			}
 			// This allows to only export the values actual needed
 			anim->translate = translate;
 			anim->rotate = rotate;
 			anim->scale = scale;
-			for (std::vector<Keyframe *>::const_iterator itr = keyframes.begin(); itr != keyframes.end(); ++itr) {
-				(*itr)->hasRotation = rotate;
-				(*itr)->hasScale = scale;
-				(*itr)->hasTranslation = translate;
-			}
+		}
 
-			if (!keyframes.empty()) {
-				anim->keyframes.push_back(keyframes[0]);
-				const int last = (int)keyframes.size()-1;
-				Keyframe *k1 = keyframes[0], *k2, *k3;
-				for (int i = 1; i < last; i++) {
-					k2 = keyframes[i];
-					k3 = keyframes[i+1];
-					// Check if the middle keyframe can be calculated by information, if so dont add it
-					if ((translate && !isLerp(k1->translation, k1->time, k2->translation, k2->time, k3->translation, k3->time, 3)) ||
-						(rotate && !isLerp(k1->rotation, k1->time, k2->rotation, k2->time, k3->rotation, k3->time, 3)) || // FIXME use slerp for quaternions
-						(scale && !isLerp(k1->scale, k1->time, k2->scale, k2->time, k3->scale, k3->time, 3))) {
-							anim->keyframes.push_back(k2);
-							k1 = k2;
-					} else
-						delete k2;
-				}
-				if (last > 0)
-					anim->keyframes.push_back(keyframes[last]);
-			}
+		/** Whether the animated components of the middle keyframe can be interpolated from its neighbours within the tolerance */
+		inline bool isLerp(const NodeAnimation *const &anim, const Keyframe &k1, const Keyframe &k2, const Keyframe &k3, const float &tolerance) {
+			return (!anim->translate || isLerp(k1.translation, k1.time, k2.translation, k2.time, k3.translation, k3.time, 3, tolerance)) &&
+				(!anim->rotate || isLerp(k1.rotation, k1.time, k2.rotation, k2.time, k3.rotation, k3.time, 3, tolerance)) && // FIXME use slerp for quaternions
+				(!anim->scale || isLerp(k1.scale, k1.time, k2.scale, k2.time, k3.scale, k3.time, 3, tolerance));
 		}
 
 		inline bool cmp(const float &v1, const float &v2, const float &epsilon = 0.000001) {
@@ -758,17 +1338,17 @@ namespace readers {
 			return ((d < 0.f) ? -d : d) < epsilon;
 		}
 
-		inline bool cmp(const float *v1, const float *v2, const unsigned int &count) {
+		inline bool cmp(const float *v1, const float *v2, const unsigned int &count, const float &epsilon = 0.000001f) {
 			for (unsigned int i = 0; i < count; i++)
-				if (!cmp(v1[i],v2[i]))
+				if (!cmp(v1[i],v2[i], epsilon))
 					return false;
 			return true;
 		}
 
-		inline bool isLerp(const float *v1, const float &t1, const float *v2, const float &t2, const float *v3, const float &t3, const int size) {
+		inline bool isLerp(const float *v1, const float &t1, const float *v2, const float &t2, const float *v3, const float &t3, const int size, const float &epsilon = 0.000001f) {
 			const double d = (t2 - t1) / (t3 - t1);
 			for (int i = 0; i < size; i++)
-				if (!cmp(v2[i], v1[i] + d * (v3[i] - v1[i])))
+				if (!cmp(v2[i], v1[i] + d * (v3[i] - v1[i]), epsilon))
 					return false;
 			return true;
 		}
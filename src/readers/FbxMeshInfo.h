@@ -36,6 +36,9 @@ using namespace fbxconv::modeldata;
 namespace fbxconv {
 namespace readers {
 	struct FbxMeshInfo {
+		// Writes the values of a single vertex, see getVertex
+		typedef void (*VertexWriter)(const FbxMeshInfo &info, float * const &data, const unsigned int &poly, const unsigned int &polyIndex, const unsigned int &point, const Matrix3<float> * const &uvTransforms);
+
 		// The source mesh of which the values below are extracted
 		FbxMesh * const mesh;
 		// The ID of the mesh (shape)
@@ -50,6 +53,8 @@ namespace readers {
 		bool bonesOverflow;
 		// The vertex attributes
 		Attributes attributes;
+		// The vertex writer for the attributes, specialized for the most common combinations of attributes
+		VertexWriter vertexWriter;
 		// Whether to use packed colors
 		const bool usePackedColors;
 		// The number of polygon (triangles if triangulated)
@@ -115,6 +120,7 @@ namespace readers {
 			pointBlendWeights(0),
 			skin((maxNodePartBoneCount > 0 && maxVertexBlendWeightCount > 0 && (unsigned int)mesh->GetDeformerCount(FbxDeformer::eSkin) > 0) ? static_cast<FbxSkin*>(mesh->GetDeformer(0, FbxDeformer::eSkin)) : 0),
 			bonesOverflow(false),
+			vertexWriter(0),
 			polyPartMap(new unsigned int[polyCount]),
 			polyPartBonesMap(new unsigned int[polyCount]),
 			id(getID(mesh))
@@ -137,6 +143,7 @@ namespace readers {
 			fetchAttributes();
 			cacheAttributes();
 			fetchUVInfo();
+			vertexWriter = getVertexWriter(attributes);
 		}
 
 		~FbxMeshInfo() {
@@ -262,10 +269,67 @@ namespace readers {
 		}
 
 		inline void getVertex(float * const &data, const unsigned int &poly, const unsigned int &polyIndex, const unsigned int &point, const Matrix3<float> * const &uvTransforms) const {
-			unsigned int offset = 0;
-			getVertex(data, offset, poly, polyIndex, point, uvTransforms);
+			vertexWriter(*this, data, poly, polyIndex, point, uvTransforms);
 		}
 	private:
+		/** Writes the vertex of a specific combination of attributes, the conditions and loops are resolved at compile time */
+		template<bool normal, bool color, bool tangents, unsigned int uvs, unsigned int weights> struct VertexLayout {
+			static const unsigned long attributes = (1UL << ATTRIBUTE_POSITION) | (normal ? (1UL << ATTRIBUTE_NORMAL) : 0UL) |
+				(color ? (1UL << ATTRIBUTE_COLOR) : 0UL) | (tangents ? ((1UL << ATTRIBUTE_TANGENT) | (1UL << ATTRIBUTE_BINORMAL)) : 0UL) |
+				(((1UL << uvs) - 1UL) << ATTRIBUTE_TEXCOORD0) | (((1UL << weights) - 1UL) << ATTRIBUTE_BLENDWEIGHT0);
+
+			static void write(const FbxMeshInfo &info, float * const &data, const unsigned int &poly, const unsigned int &polyIndex, const unsigned int &point, const Matrix3<float> * const &uvTransforms) {
+				unsigned int offset = 0;
+				info.getPosition(data, offset, point);
+				if (normal)
+					info.getNormal(data, offset, polyIndex, point);
+				if (color)
+					info.getColor(data, offset, polyIndex, point);
+				if (tangents) {
+					info.getTangent(data, offset, polyIndex, point);
+					info.getBinormal(data, offset, polyIndex, point);
+				}
+				for (unsigned int i = 0; i < uvs; i++)
+					info.getUV(data, offset, i, polyIndex, point, uvTransforms[i]);
+				for (unsigned int i = 0; i < weights; i++)
+					info.getBlendWeight(data, offset, i, poly, polyIndex, point);
+			}
+		};
+
+		static void writeVertex(const FbxMeshInfo &info, float * const &data, const unsigned int &poly, const unsigned int &polyIndex, const unsigned int &point, const Matrix3<float> * const &uvTransforms) {
+			unsigned int offset = 0;
+			info.getVertex(data, offset, poly, polyIndex, point, uvTransforms);
+		}
+
+		/** Returns the specialized vertex writer for the attributes if available, otherwise the generic one */
+		static VertexWriter getVertexWriter(const Attributes &attributes) {
+#define FBXCONV_VERTEX_LAYOUT(normal, color, tangents, uvs, weights) \
+			{ VertexLayout<normal, color, tangents, uvs, weights>::attributes, &VertexLayout<normal, color, tangents, uvs, weights>::write }
+			static const struct {
+				unsigned long attributes;
+				VertexWriter writer;
+			} layouts[] = {
+				FBXCONV_VERTEX_LAYOUT(false, false, false, 1, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 0, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 1, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 2, 0),
+				FBXCONV_VERTEX_LAYOUT(true, true, false, 0, 0),
+				FBXCONV_VERTEX_LAYOUT(true, true, false, 1, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, true, 1, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, true, 2, 0),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 1, 1),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 1, 2),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 1, 3),
+				FBXCONV_VERTEX_LAYOUT(true, false, false, 1, 4),
+				FBXCONV_VERTEX_LAYOUT(true, false, true, 1, 4)
+			};
+#undef FBXCONV_VERTEX_LAYOUT
+			for (unsigned int i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++)
+				if (layouts[i].attributes == attributes.value)
+					return layouts[i].writer;
+			return &writeVertex;
+		}
+
 		static std::string getID(FbxMesh * const &mesh) {
 			static int idCounter = 0;
 			const char *name = mesh->GetName();
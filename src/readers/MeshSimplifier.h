@@ -0,0 +1,370 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_READERS_MESHSIMPLIFIER_H
+#define FBXCONV_READERS_MESHSIMPLIFIER_H
+
+#include <vector>
+#include <map>
+#include <set>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include "../modeldata/Mesh.h"
+
+using namespace fbxconv::modeldata;
+
+namespace fbxconv {
+namespace readers {
+	/** Reduces the triangles of a mesh part using quadric error (half) edge collapses. The vertices of the mesh are not modified,
+	 * each level of detail only consists of a new list of indices into the same vertices. Vertices which share their position
+	 * (e.g. at uv seams) are collapsed together and vertices shared with other parts are preserved. Vertices on the border of the
+	 * part are only collapsed along the border (onto a neighbouring border vertex), so the outline is simplified but doesn't
+	 * move inwards. Vertices are only collapsed onto vertices that are influenced by the same bones. */
+	class MeshSimplifier {
+	public:
+		MeshSimplifier(const Mesh * const &mesh, const std::vector<unsigned short> &indices, const std::vector<bool> &locked)
+			: mesh(mesh), aliveCount(0) {
+			init(indices, locked);
+		}
+
+		/** The number of triangles left */
+		inline unsigned int triangleCount() const {
+			return aliveCount;
+		}
+
+		/** Collapse edges until at most targetCount triangles are left or no more edges can be collapsed,
+		 * returns false if the target couldn't be reached. */
+		bool simplify(const unsigned int &targetCount) {
+			while (aliveCount > targetCount && !queue.empty()) {
+				const Collapse c = queue.top();
+				queue.pop();
+				if (groups[c.from].dead || groups[c.to].dead || groups[c.from].version != c.fromVersion || groups[c.to].version != c.toVersion)
+					continue;
+				if (canCollapse(c.from, c.to))
+					collapse(c.from, c.to);
+			}
+			return aliveCount <= targetCount;
+		}
+
+		/** Get the indices of the triangles that are left */
+		void getIndices(std::vector<unsigned short> &out) const {
+			out.clear();
+			out.reserve(aliveCount * 3);
+			for (unsigned int t = 0; t < alive.size(); t++)
+				if (alive[t])
+					for (unsigned int i = 0; i < 3; i++)
+						out.push_back((unsigned short)wedges[triangles[t*3+i]].vertex);
+		}
+
+	private:
+		struct Wedge {
+			unsigned int vertex;
+			unsigned int group;
+			std::vector<int> bones;
+		};
+
+		struct Group {
+			float position[3];
+			double quadric[10];
+			std::vector<unsigned int> triangles;
+			unsigned int version;
+			bool locked;
+			bool border;
+			bool dead;
+			Group() : version(0), locked(false), border(false), dead(false) {
+				memset(quadric, 0, sizeof(quadric));
+			}
+		};
+
+		struct Collapse {
+			double cost;
+			unsigned int from, to, fromVersion, toVersion;
+			inline bool operator>(const Collapse &rhs) const {
+				return cost > rhs.cost;
+			}
+		};
+
+		const Mesh * const mesh;
+		std::vector<Wedge> wedges;
+		std::vector<Group> groups;
+		std::vector<unsigned int> triangles;
+		std::vector<bool> alive;
+		unsigned int aliveCount;
+		std::set<std::pair<unsigned int, unsigned int> > borderEdges;
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > queue;
+		/** Temp mapping between the wedges of the group being collapsed and the wedges they collapse onto */
+		std::map<unsigned int, unsigned int> wedgeMap;
+
+		inline const float *position(const unsigned int &vertex) const {
+			return &(mesh->vertices[vertex * mesh->vertexSize]);
+		}
+
+		inline static std::pair<unsigned int, unsigned int> edge(const unsigned int &a, const unsigned int &b) {
+			return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+		}
+
+		void init(const std::vector<unsigned short> &indices, const std::vector<bool> &locked) {
+			// Find the offsets of the blend weights, used to only collapse vertices influenced by the same bones
+			std::vector<unsigned int> blendOffsets;
+			unsigned int offset = 0;
+			for (unsigned int a = 0; a < ATTRIBUTE_COUNT; a++) {
+				if (!mesh->attributes.has(a))
+					continue;
+				if (a >= ATTRIBUTE_BLENDWEIGHT0 && a <= ATTRIBUTE_BLENDWEIGHT7)
+					blendOffsets.push_back(offset);
+				offset += (unsigned int)ATTRIBUTE_SIZE(a);
+			}
+
+			// Each unique vertex is a wedge, wedges with the same position are grouped
+			std::map<unsigned int, unsigned int> vertexWedge;
+			std::map<std::vector<float>, unsigned int> positionGroup;
+			const unsigned int count = (unsigned int)indices.size() / 3;
+			triangles.resize(count * 3);
+			for (unsigned int i = 0; i < count * 3; i++) {
+				const unsigned int vertex = indices[i];
+				std::map<unsigned int, unsigned int>::const_iterator it = vertexWedge.find(vertex);
+				if (it != vertexWedge.end()) {
+					triangles[i] = it->second;
+					continue;
+				}
+				const float *p = position(vertex);
+				const std::vector<float> key(p, p + 3);
+				std::map<std::vector<float>, unsigned int>::const_iterator gt = positionGroup.find(key);
+				Wedge wedge;
+				wedge.vertex = vertex;
+				if (gt != positionGroup.end())
+					wedge.group = gt->second;
+				else {
+					wedge.group = positionGroup[key] = (unsigned int)groups.size();
+					groups.push_back(Group());
+					memcpy(groups.back().position, p, 3 * sizeof(float));
+				}
+				if (vertex < locked.size() && locked[vertex])
+					groups[wedge.group].locked = true;
+				const float *v = &(mesh->vertices[vertex * mesh->vertexSize]);
+				for (std::vector<unsigned int>::const_iterator bt = blendOffsets.begin(); bt != blendOffsets.end(); ++bt)
+					if (v[(*bt)+1] > 0.f)
+						wedge.bones.push_back((int)v[*bt]);
+				std::sort(wedge.bones.begin(), wedge.bones.end());
+				triangles[i] = vertexWedge[vertex] = (unsigned int)wedges.size();
+				wedges.push_back(wedge);
+			}
+
+			// Triangles (with their area weighted plane) and edges per group
+			std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeCount;
+			alive.resize(count, true);
+			aliveCount = count;
+			for (unsigned int t = 0; t < count; t++) {
+				const unsigned int g[3] = {wedges[triangles[t*3]].group, wedges[triangles[t*3+1]].group, wedges[triangles[t*3+2]].group};
+				if (g[0] == g[1] || g[1] == g[2] || g[2] == g[0]) {
+					alive[t] = false;
+					aliveCount--;
+					continue;
+				}
+				double n[3];
+				const double area = normal(groups[g[0]].position, groups[g[1]].position, groups[g[2]].position, n);
+				for (unsigned int i = 0; i < 3; i++) {
+					groups[g[i]].triangles.push_back(t);
+					addPlane(groups[g[i]].quadric, n, groups[g[0]].position, area);
+					edgeCount[edge(g[i], g[(i+1)%3])]++;
+				}
+			}
+
+			// Border edges are constrained by a plane perpendicular to the triangle
+			for (unsigned int t = 0; t < count; t++) {
+				if (!alive[t])
+					continue;
+				const unsigned int g[3] = {wedges[triangles[t*3]].group, wedges[triangles[t*3+1]].group, wedges[triangles[t*3+2]].group};
+				double n[3];
+				normal(groups[g[0]].position, groups[g[1]].position, groups[g[2]].position, n);
+				for (unsigned int i = 0; i < 3; i++) {
+					const unsigned int a = g[i], b = g[(i+1)%3];
+					if (edgeCount[edge(a, b)] != 1)
+						continue;
+					borderEdges.insert(edge(a, b));
+					groups[a].border = groups[b].border = true;
+					const float *pa = groups[a].position, *pb = groups[b].position;
+					const double e[3] = {pb[0]-pa[0], pb[1]-pa[1], pb[2]-pa[2]};
+					double m[3] = {e[1]*n[2]-e[2]*n[1], e[2]*n[0]-e[0]*n[2], e[0]*n[1]-e[1]*n[0]};
+					const double len = sqrt(m[0]*m[0] + m[1]*m[1] + m[2]*m[2]);
+					if (len <= 0.0)
+						continue;
+					m[0] /= len; m[1] /= len; m[2] /= len;
+					const double weight = 10.0 * (e[0]*e[0] + e[1]*e[1] + e[2]*e[2]);
+					addPlane(groups[a].quadric, m, pa, weight);
+					addPlane(groups[b].quadric, m, pa, weight);
+				}
+			}
+
+			for (unsigned int t = 0; t < count; t++)
+				if (alive[t])
+					for (unsigned int i = 0; i < 3; i++)
+						push(wedges[triangles[t*3+i]].group, wedges[triangles[t*3+(i+1)%3]].group);
+		}
+
+		/** Calculates the unit normal of the triangle and returns its area */
+		inline static double normal(const float *p0, const float *p1, const float *p2, double *n) {
+			const double u[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+			const double v[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+			n[0] = u[1]*v[2] - u[2]*v[1];
+			n[1] = u[2]*v[0] - u[0]*v[2];
+			n[2] = u[0]*v[1] - u[1]*v[0];
+			const double len = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+			if (len > 0.0) {
+				n[0] /= len; n[1] /= len; n[2] /= len;
+			}
+			return len * 0.5;
+		}
+
+		inline static void addPlane(double * const &q, const double *n, const float *p, const double &weight) {
+			const double d = -(n[0]*p[0] + n[1]*p[1] + n[2]*p[2]);
+			q[0] += weight * n[0]*n[0]; q[1] += weight * n[0]*n[1]; q[2] += weight * n[0]*n[2]; q[3] += weight * n[0]*d;
+			q[4] += weight * n[1]*n[1]; q[5] += weight * n[1]*n[2]; q[6] += weight * n[1]*d;
+			q[7] += weight * n[2]*n[2]; q[8] += weight * n[2]*d;
+			q[9] += weight * d*d;
+		}
+
+		inline double cost(const unsigned int &from, const unsigned int &to) const {
+			const double *a = groups[from].quadric, *b = groups[to].quadric;
+			const float *p = groups[to].position;
+			const double x = p[0], y = p[1], z = p[2];
+			return	(a[0]+b[0])*x*x + 2.0*(a[1]+b[1])*x*y + 2.0*(a[2]+b[2])*x*z + 2.0*(a[3]+b[3])*x +
+					(a[4]+b[4])*y*y + 2.0*(a[5]+b[5])*y*z + 2.0*(a[6]+b[6])*y +
+					(a[7]+b[7])*z*z + 2.0*(a[8]+b[8])*z + (a[9]+b[9]);
+		}
+
+		inline void push(const unsigned int &from, const unsigned int &to) {
+			if (groups[from].locked || (groups[from].border && borderEdges.find(edge(from, to)) == borderEdges.end()))
+				return;
+			Collapse c;
+			c.cost = cost(from, to);
+			c.from = from;
+			c.to = to;
+			c.fromVersion = groups[from].version;
+			c.toVersion = groups[to].version;
+			queue.push(c);
+		}
+
+		/** Check whether each wedge of the group collapses onto exactly one wedge (with the same bones) of the target group and no triangle flips */
+		bool canCollapse(const unsigned int &from, const unsigned int &to) {
+			wedgeMap.clear();
+			const std::vector<unsigned int> &tris = groups[from].triangles;
+			for (std::vector<unsigned int>::const_iterator it = tris.begin(); it != tris.end(); ++it) {
+				if (!alive[*it])
+					continue;
+				const unsigned int *t = &triangles[(*it)*3];
+				int u = -1, v = -1;
+				for (unsigned int i = 0; i < 3; i++) {
+					if (wedges[t[i]].group == from)
+						u = (int)t[i];
+					else if (wedges[t[i]].group == to)
+						v = (int)t[i];
+				}
+				if (v < 0)
+					continue;
+				std::map<unsigned int, unsigned int>::const_iterator mt = wedgeMap.find((unsigned int)u);
+				if (mt != wedgeMap.end() && mt->second != (unsigned int)v)
+					return false;
+				if (wedges[u].bones != wedges[v].bones)
+					return false;
+				wedgeMap[(unsigned int)u] = (unsigned int)v;
+			}
+			const float *target = groups[to].position;
+			for (std::vector<unsigned int>::const_iterator it = tris.begin(); it != tris.end(); ++it) {
+				if (!alive[*it])
+					continue;
+				const unsigned int *t = &triangles[(*it)*3];
+				const float *p[3];
+				bool degenerate = false;
+				for (unsigned int i = 0; i < 3; i++) {
+					const unsigned int g = wedges[t[i]].group;
+					if (g == to)
+						degenerate = true;
+					else if (g == from && wedgeMap.find(t[i]) == wedgeMap.end())
+						return false;
+				}
+				if (degenerate)
+					continue;
+				double n0[3], n1[3];
+				for (unsigned int i = 0; i < 3; i++)
+					p[i] = groups[wedges[t[i]].group].position;
+				normal(p[0], p[1], p[2], n0);
+				for (unsigned int i = 0; i < 3; i++)
+					if (wedges[t[i]].group == from)
+						p[i] = target;
+				if (normal(p[0], p[1], p[2], n1) <= 0.0 || (n0[0]*n1[0] + n0[1]*n1[1] + n0[2]*n1[2]) < 0.2)
+					return false;
+			}
+			return !wedgeMap.empty();
+		}
+
+		void collapse(const unsigned int &from, const unsigned int &to) {
+			Group &src = groups[from], &dst = groups[to];
+			for (std::vector<unsigned int>::const_iterator it = src.triangles.begin(); it != src.triangles.end(); ++it) {
+				if (!alive[*it])
+					continue;
+				unsigned int *t = &triangles[(*it)*3];
+				bool degenerate = false;
+				for (unsigned int i = 0; i < 3; i++) {
+					if (wedges[t[i]].group == to)
+						degenerate = true;
+					else if (wedges[t[i]].group == from)
+						t[i] = wedgeMap[t[i]];
+				}
+				if (degenerate) {
+					alive[*it] = false;
+					aliveCount--;
+				}
+				else
+					dst.triangles.push_back(*it);
+			}
+			for (unsigned int i = 0; i < 10; i++)
+				dst.quadric[i] += src.quadric[i];
+			if (src.border) {
+				std::vector<std::pair<unsigned int, unsigned int> > moved;
+				for (std::set<std::pair<unsigned int, unsigned int> >::const_iterator it = borderEdges.begin(); it != borderEdges.end(); ++it)
+					if (it->first == from || it->second == from)
+						moved.push_back(*it);
+				for (std::vector<std::pair<unsigned int, unsigned int> >::const_iterator it = moved.begin(); it != moved.end(); ++it) {
+					borderEdges.erase(*it);
+					const unsigned int other = it->first == from ? it->second : it->first;
+					if (other != to)
+						borderEdges.insert(edge(other, to));
+				}
+			}
+			src.dead = true;
+			src.triangles.clear();
+			dst.version++;
+			for (std::vector<unsigned int>::const_iterator it = dst.triangles.begin(); it != dst.triangles.end(); ++it) {
+				if (!alive[*it])
+					continue;
+				for (unsigned int i = 0; i < 3; i++) {
+					const unsigned int g = wedges[triangles[(*it)*3+i]].group;
+					if (g != to) {
+						push(g, to);
+						push(to, g);
+					}
+				}
+			}
+		}
+	};
+} }
+#endif //FBXCONV_READERS_MESHSIMPLIFIER_H
@@ -0,0 +1,603 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_READERS_OBJREADER_H
+#define FBXCONV_READERS_OBJREADER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string.h>
+#include <math.h>
+#include "../Settings.h"
+#include "Reader.h"
+#include "TextureFileInfo.h"
+#include "TriangleStripper.h"
+#include "../util/mappedfile.h"
+#include "../util/thread.h"
+#include "../log/log.h"
+
+using namespace fbxconv::modeldata;
+
+namespace fbxconv {
+namespace readers {
+	/** Reads a Wavefront OBJ file and the MTL material libraries it references, without using the FBX SDK. The file is mapped
+	 * into memory and split into chunks of whole lines, which are parsed concurrently. Each object or group becomes a node,
+	 * with a part for each material it uses. Polygons are triangulated as a fan. */
+	class ObjReader : public Reader, public util::Job {
+	public:
+		ObjReader(fbxconv::log::Log *log, TextureInfoCallback textureCallback)
+			: log(log), textureCallback(textureCallback), settings(0), invalidFaces(0) {}
+
+		virtual ~ObjReader() {
+			for (std::map<std::string, Material *>::iterator itr = materials.begin(); itr != materials.end(); ++itr)
+				delete itr->second;
+		}
+
+		virtual bool load(Settings *settings) {
+			this->settings = settings;
+			util::MappedFile file;
+			if (!file.open(settings->inFile.c_str())) {
+				log->error(log::eSourceLoadObjFile, settings->inFile.c_str());
+				return false;
+			}
+
+			const unsigned int threads = settings->threadCount > 0 ? (unsigned int)settings->threadCount : util::hardwareThreads();
+			static const size_t minChunkSize = 64 * 1024;
+			size_t chunkSize = file.size / (threads * 4) + 1;
+			if (chunkSize < minChunkSize)
+				chunkSize = minChunkSize;
+			chunks.clear();
+			for (const char *p = file.data, * const end = file.data + file.size; p < end;) {
+				const char *e = (size_t)(end - p) > chunkSize ? p + chunkSize : end;
+				while (e < end && e[-1] != '\n')
+					e++;
+				chunks.push_back(Chunk(p, e));
+				p = e;
+			}
+			util::parallelFor(*this, (unsigned int)chunks.size(), threads);
+			file.close();
+
+			merge();
+			const std::string directory = TextureFileInfo::getDirectory(settings->inFile);
+			for (std::vector<std::string>::const_iterator itr = libraries.begin(); itr != libraries.end(); ++itr) {
+				const std::string filename = TextureFileInfo::locate(*itr, directory);
+				if (filename.empty() || !loadLibrary(filename))
+					log->warning(log::wSourceLoadObjLibrary, itr->c_str());
+			}
+			if (invalidFaces > 0)
+				log->warning(log::wSourceLoadObjInvalidFaces, (int)invalidFaces);
+			log->verbose(log::iSourceLoadObj, (int)(positions.size() / 3), (int)groups.size(), (int)chunks.size(), (int)threads);
+			chunks.clear();
+			return true;
+		}
+
+		virtual bool convert(Model * const &model) {
+			bool hasNormals = false, hasUVs = false;
+			for (std::vector<Group>::iterator itr = groups.begin(); itr != groups.end(); ++itr) {
+				hasNormals = hasNormals || itr->hasNormals;
+				hasUVs = hasUVs || itr->hasUVs;
+				Material *&material = materials[itr->material];
+				if (material == 0) {
+					if (!itr->material.empty())
+						log->warning(log::wSourceConvertObjNoMaterial, itr->material.c_str());
+					static const float gray[3] = {0.8f, 0.8f, 0.8f};
+					material = new Material();
+					material->id = itr->material.empty() ? "default" : itr->material;
+					material->diffuse.set(gray);
+				}
+				if (itr->hasUVs)
+					fetchTextureBounds(*itr, material);
+			}
+
+			if (textureCallback)
+				textureCallback(textureFiles, settings, log);
+			std::set<Material *> used;
+			for (std::vector<Group>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr) {
+				Material * const &material = materials[itr->material];
+				if (!used.insert(material).second)
+					continue;
+				for (std::vector<Material::Texture *>::iterator tt = material->textures.begin(); tt != material->textures.end(); ++tt)
+					(*tt)->path = textureFiles[(*tt)->path].path;
+				model->materials.push_back(material);
+			}
+
+			Attributes attributes;
+			attributes.hasPosition(true);
+			attributes.set(ATTRIBUTE_NORMAL, hasNormals);
+			attributes.set(ATTRIBUTE_TEXCOORD0, hasUVs);
+			std::map<std::string, Node *> nodes;
+			Mesh *mesh = 0;
+			unsigned int indexCount = 0;
+			std::vector<float> vertex(attributes.size());
+			for (std::vector<Group>::const_iterator itr = groups.begin(); itr != groups.end(); ++itr) {
+				Node *&node = nodes[itr->object];
+				if (node == 0) {
+					node = new Node(itr->object.empty() ? "default" : itr->object.c_str());
+					while (model->getNode(node->id.c_str()))
+						node->id += "_";
+					model->nodes.push_back(node);
+				}
+				const Material * const material = materials[itr->material];
+				MeshPart *part = 0;
+				for (std::vector<int>::const_iterator it = itr->corners.begin(); it != itr->corners.end(); it += 9) {
+					if (mesh == 0 || mesh->vertices.size() / mesh->vertexSize + 3 > (size_t)settings->maxVertexCount || indexCount + 3 > (unsigned int)settings->maxIndexCount) {
+						if (part)
+							calcBoundingSphere(mesh, part);
+						if (mesh && settings->triangleStrips)
+							TriangleStripper::stripify(mesh);
+						if (mesh && meshListener)
+							meshListener->meshCompleted(mesh);
+						mesh = createMesh(model, attributes);
+						indexCount = 0;
+						part = 0;
+					}
+					if (part == 0)
+						part = addPart(mesh, node, material, hasUVs);
+					for (int i = 0; i < 9; i += 3) {
+						getVertex(&vertex[0], &it[i], hasNormals, hasUVs);
+						part->indices.push_back((unsigned short)mesh->add(&vertex[0]));
+						part->bounds.ext(&vertex[0]);
+					}
+					indexCount += 3;
+				}
+				if (part)
+					calcBoundingSphere(mesh, part);
+			}
+			if (mesh && settings->triangleStrips)
+				TriangleStripper::stripify(mesh);
+			if (mesh && meshListener)
+				meshListener->meshCompleted(mesh);
+			for (std::map<std::string, Node *>::iterator itr = nodes.begin(); itr != nodes.end(); ++itr)
+				for (std::vector<NodePart *>::const_iterator it = itr->second->parts.begin(); it != itr->second->parts.end(); ++it)
+					itr->second->bounds.ext((*it)->meshPart->bounds);
+			// The model owns the used materials now
+			for (std::map<std::string, Material *>::iterator itr = materials.begin(); itr != materials.end(); ++itr)
+				if (used.find(itr->second) == used.end())
+					delete itr->second;
+			materials.clear();
+			return true;
+		}
+
+		/** Parse a single chunk, called concurrently, so it must not use the log */
+		virtual void execute(const unsigned int &index) {
+			Chunk &chunk = chunks[index];
+			const char *p = chunk.begin;
+			while (p < chunk.end) {
+				const char *end = p;
+				while (end < chunk.end && *end != '\n' && *end != '\r')
+					end++;
+				parseLine(chunk, p, end);
+				p = end + 1;
+			}
+		}
+
+	private:
+		/** A polygon, the counts are the number of elements in the chunk before the face (for relative indices) */
+		struct Face {
+			int object, material;
+			unsigned int firstCorner, cornerCount;
+			unsigned int positionCount, uvCount, normalCount;
+		};
+
+		struct Chunk {
+			const char *begin, *end;
+			std::vector<float> positions, uvs, normals;
+			/** The position, uv and normal index of each corner as specified in the file (1 based, negative for relative, 0 if absent) */
+			std::vector<int> corners;
+			std::vector<Face> faces;
+			/** The object, material and library names used within the chunk, the faces refer to them by index (-1 to continue the previous chunk) */
+			std::vector<std::string> objects, materials, libraries;
+			int object, material;
+			Chunk(const char * const &begin, const char * const &end) : begin(begin), end(end), object(-1), material(-1) {}
+		};
+
+		/** The triangles of an object with the same material */
+		struct Group {
+			std::string object, material;
+			/** The zero based position, uv and normal index (-1 if absent) of each triangle corner */
+			std::vector<int> corners;
+			bool hasNormals, hasUVs;
+			Group() : hasNormals(false), hasUVs(false) {}
+		};
+
+		fbxconv::log::Log *log;
+		TextureInfoCallback textureCallback;
+		Settings *settings;
+		std::vector<Chunk> chunks;
+		std::vector<float> positions, uvs, normals;
+		std::vector<Group> groups;
+		std::vector<std::string> libraries;
+		/** The materials by name, which are moved to the model by convert() */
+		std::map<std::string, Material *> materials;
+		std::map<std::string, TextureFileInfo> textureFiles;
+		unsigned int invalidFaces;
+
+		void parseLine(Chunk &chunk, const char *p, const char * const &end) {
+			skipSpace(p, end);
+			if (p >= end || *p == '#')
+				return;
+			const char *keyword = p;
+			while (p < end && !isSpace(*p))
+				p++;
+			const size_t length = p - keyword;
+			skipSpace(p, end);
+			if (length == 1 && keyword[0] == 'v')
+				parseFloats(chunk.positions, p, end, 3);
+			else if (length == 2 && keyword[0] == 'v' && keyword[1] == 't')
+				parseFloats(chunk.uvs, p, end, 2);
+			else if (length == 2 && keyword[0] == 'v' && keyword[1] == 'n')
+				parseFloats(chunk.normals, p, end, 3);
+			else if (length == 1 && keyword[0] == 'f')
+				parseFace(chunk, p, end);
+			else if (length == 1 && (keyword[0] == 'o' || keyword[0] == 'g')) {
+				chunk.object = (int)chunk.objects.size();
+				chunk.objects.push_back(trim(p, end));
+			}
+			else if (length == 6 && strncmp(keyword, "usemtl", 6) == 0) {
+				chunk.material = (int)chunk.materials.size();
+				chunk.materials.push_back(trim(p, end));
+			}
+			else if (length == 6 && strncmp(keyword, "mtllib", 6) == 0)
+				chunk.libraries.push_back(trim(p, end));
+		}
+
+		void parseFace(Chunk &chunk, const char *p, const char * const &end) {
+			Face face;
+			face.object = chunk.object;
+			face.material = chunk.material;
+			face.firstCorner = (unsigned int)chunk.corners.size();
+			face.positionCount = (unsigned int)chunk.positions.size() / 3;
+			face.uvCount = (unsigned int)chunk.uvs.size() / 2;
+			face.normalCount = (unsigned int)chunk.normals.size() / 3;
+			while (p < end) {
+				int v = parseInt(p, end), t = 0, n = 0;
+				if (p < end && *p == '/') {
+					p++;
+					if (p < end && *p != '/')
+						t = parseInt(p, end);
+					if (p < end && *p == '/') {
+						p++;
+						n = parseInt(p, end);
+					}
+				}
+				while (p < end && !isSpace(*p))
+					p++;
+				skipSpace(p, end);
+				chunk.corners.push_back(v);
+				chunk.corners.push_back(t);
+				chunk.corners.push_back(n);
+			}
+			face.cornerCount = ((unsigned int)chunk.corners.size() - face.firstCorner) / 3;
+			chunk.faces.push_back(face);
+		}
+
+		/** Combine the chunks, resolve the relative indices and group the triangles by object and material */
+		void merge() {
+			unsigned int positionCount = 0, uvCount = 0, normalCount = 0;
+			for (std::vector<Chunk>::const_iterator itr = chunks.begin(); itr != chunks.end(); ++itr) {
+				positionCount += (unsigned int)itr->positions.size() / 3;
+				uvCount += (unsigned int)itr->uvs.size() / 2;
+				normalCount += (unsigned int)itr->normals.size() / 3;
+			}
+			positions.reserve(positionCount * 3);
+			uvs.reserve(uvCount * 2);
+			normals.reserve(normalCount * 3);
+
+			std::map<std::pair<std::string, std::string>, unsigned int> groupIndices;
+			std::string object, material;
+			for (std::vector<Chunk>::iterator itr = chunks.begin(); itr != chunks.end(); ++itr) {
+				const int positionBase = (int)positions.size() / 3, uvBase = (int)uvs.size() / 2, normalBase = (int)normals.size() / 3;
+				positions.insert(positions.end(), itr->positions.begin(), itr->positions.end());
+				uvs.insert(uvs.end(), itr->uvs.begin(), itr->uvs.end());
+				normals.insert(normals.end(), itr->normals.begin(), itr->normals.end());
+				libraries.insert(libraries.end(), itr->libraries.begin(), itr->libraries.end());
+				Group *group = 0;
+				int lastObject = -2, lastMaterial = -2;
+				for (std::vector<Face>::const_iterator face = itr->faces.begin(); face != itr->faces.end(); ++face) {
+					if (group == 0 || face->object != lastObject || face->material != lastMaterial) {
+						lastObject = face->object;
+						lastMaterial = face->material;
+						const std::pair<std::string, std::string> key(face->object < 0 ? object : itr->objects[face->object], face->material < 0 ? material : itr->materials[face->material]);
+						std::map<std::pair<std::string, std::string>, unsigned int>::iterator it = groupIndices.find(key);
+						if (it == groupIndices.end()) {
+							it = groupIndices.insert(std::make_pair(key, (unsigned int)groups.size())).first;
+							groups.push_back(Group());
+							groups.back().object = key.first;
+							groups.back().material = key.second;
+						}
+						group = &groups[it->second];
+					}
+					int corners[3 * 3];
+					bool valid = face->cornerCount >= 3;
+					for (unsigned int i = 0; valid && i < face->cornerCount; i++) {
+						const int * const corner = &itr->corners[face->firstCorner + i * 3];
+						// Fan triangulation: the first corner of the polygon, the previous and the current corner
+						const int slot = i < 3 ? i : 2;
+						if (i >= 3)
+							memcpy(&corners[3], &corners[6], 3 * sizeof(int));
+						valid = resolve(corners[slot * 3], corner[0], positionBase + face->positionCount, positionCount) &&
+							resolve(corners[slot * 3 + 1], corner[1], uvBase + face->uvCount, uvCount) &&
+							resolve(corners[slot * 3 + 2], corner[2], normalBase + face->normalCount, normalCount) &&
+							corners[slot * 3] >= 0;
+						if (valid && i >= 2)
+							addTriangle(*group, corners);
+					}
+					if (!valid)
+						invalidFaces++;
+				}
+				if (itr->object >= 0)
+					object = itr->objects[itr->object];
+				if (itr->material >= 0)
+					material = itr->materials[itr->material];
+			}
+		}
+
+		/** Convert the index of the file to a zero based index, or -1 if absent. Returns false if the index is out of range. */
+		static bool resolve(int &result, const int &index, const unsigned int &current, const unsigned int &count) {
+			result = index > 0 ? index - 1 : (index < 0 ? (int)current + index : -1);
+			return (index == 0 || result >= 0) && result < (int)count;
+		}
+
+		void addTriangle(Group &group, const int * const &corners) {
+			group.corners.insert(group.corners.end(), &corners[0], &corners[9]);
+			for (int i = 0; i < 9; i += 3) {
+				group.hasUVs = group.hasUVs || corners[i + 1] >= 0;
+				group.hasNormals = group.hasNormals || corners[i + 2] >= 0;
+			}
+		}
+
+		/** Parse a MTL file, returns false if it can't be read */
+		bool loadLibrary(const std::string &filename) {
+			util::MappedFile file;
+			if (!file.open(filename.c_str()))
+				return false;
+			Material *material = 0;
+			for (const char *p = file.data, * const end = file.data + file.size; p < end;) {
+				const char *e = p;
+				while (e < end && *e != '\n' && *e != '\r')
+					e++;
+				parseMaterialLine(material, p, e);
+				p = e + 1;
+			}
+			return true;
+		}
+
+		void parseMaterialLine(Material *&material, const char *p, const char * const &end) {
+			skipSpace(p, end);
+			if (p >= end || *p == '#')
+				return;
+			const char *start = p;
+			while (p < end && !isSpace(*p))
+				p++;
+			const std::string keyword(start, p);
+			skipSpace(p, end);
+			if (keyword == "newmtl") {
+				const std::string name = trim(p, end);
+				Material *&m = materials[name];
+				if (m == 0) {
+					m = new Material();
+					m->id = name;
+				}
+				material = m;
+				return;
+			}
+			if (material == 0)
+				return;
+			float color[3];
+			if (keyword == "Kd")
+				material->diffuse.set(parseColor(color, p, end));
+			else if (keyword == "Ka")
+				material->ambient.set(parseColor(color, p, end));
+			else if (keyword == "Ks")
+				material->specular.set(parseColor(color, p, end));
+			else if (keyword == "Ke")
+				material->emissive.set(parseColor(color, p, end));
+			else if (keyword == "Ns")
+				material->shininess.set(parseFloat(p, end));
+			else if (keyword == "d")
+				material->opacity.set(parseFloat(p, end));
+			else if (keyword == "Tr")
+				material->opacity.set(1.f - parseFloat(p, end));
+			else if (keyword == "map_Kd")
+				addTexture(material, p, end, Material::Texture::Diffuse);
+			else if (keyword == "map_Ka")
+				addTexture(material, p, end, Material::Texture::Ambient);
+			else if (keyword == "map_Ks")
+				addTexture(material, p, end, Material::Texture::Specular);
+			else if (keyword == "map_Ke")
+				addTexture(material, p, end, Material::Texture::Emissive);
+			else if (keyword == "map_Ns")
+				addTexture(material, p, end, Material::Texture::Shininess);
+			else if (keyword == "map_d")
+				addTexture(material, p, end, Material::Texture::Transparency);
+			else if (keyword == "map_bump" || keyword == "bump" || keyword == "map_Bump")
+				addTexture(material, p, end, Material::Texture::Bump);
+			else if (keyword == "norm" || keyword == "map_Kn")
+				addTexture(material, p, end, Material::Texture::Normal);
+			else if (keyword == "refl")
+				addTexture(material, p, end, Material::Texture::Reflection);
+		}
+
+		/** Parse an RGB color, a single value is used for all components */
+		static float (&parseColor(float (&color)[3], const char *p, const char * const &end))[3] {
+			color[0] = color[1] = color[2] = parseFloat(p, end);
+			if (p < end) {
+				color[1] = parseFloat(p, end);
+				color[2] = p < end ? parseFloat(p, end) : 0.f;
+			}
+			return color;
+		}
+
+		/** Add the texture, the options (e.g. "-bm 1.0") before the filename are ignored */
+		void addTexture(Material * const &material, const char *p, const char * const &end, const Material::Texture::Usage &usage) {
+			std::string filename = trim(p, end);
+			std::string::size_type pos;
+			while (!filename.empty() && filename[0] == '-' && (pos = filename.find_last_of(" \t")) != std::string::npos)
+				filename = filename.substr(pos + 1);
+			if (filename.empty())
+				return;
+			Material::Texture *texture = new Material::Texture();
+			const std::string name = filename.substr(filename.find_last_of("/\\") + 1);
+			texture->id = name.substr(0, name.find_last_of('.'));
+			texture->path = filename;
+			texture->usage = usage;
+			material->textures.push_back(texture);
+			textureFiles[filename].textures.push_back(texture);
+		}
+
+		/** Extend the uv bounds of the textures of the material with the texture coordinates of the group */
+		void fetchTextureBounds(const Group &group, const Material * const &material) {
+			float bounds[4] = {0.f, 0.f, 0.f, 0.f};
+			bool first = true;
+			for (std::vector<int>::const_iterator itr = group.corners.begin(); itr != group.corners.end(); itr += 3) {
+				if (itr[1] < 0)
+					continue;
+				const float u = uvs[itr[1] * 2], v = uvs[itr[1] * 2 + 1];
+				if (first || u < bounds[0]) bounds[0] = u;
+				if (first || v < bounds[1]) bounds[1] = v;
+				if (first || u > bounds[2]) bounds[2] = u;
+				if (first || v > bounds[3]) bounds[3] = v;
+				first = false;
+			}
+			if (first)
+				return;
+			for (std::vector<Material::Texture *>::const_iterator itr = material->textures.begin(); itr != material->textures.end(); ++itr) {
+				TextureFileInfo &info = textureFiles[(*itr)->path];
+				const bool set = info.hasBounds();
+				for (int i = 0; i < 2; i++) {
+					if (!set || bounds[i] < info.bounds[i])
+						info.bounds[i] = bounds[i];
+					if (!set || bounds[i + 2] > info.bounds[i + 2])
+						info.bounds[i + 2] = bounds[i + 2];
+				}
+				info.nodeCount++;
+			}
+		}
+
+		Mesh *createMesh(Model * const &model, const Attributes &attributes) {
+			Mesh *mesh = new Mesh();
+			model->meshes.push_back(mesh);
+			mesh->attributes = attributes;
+			mesh->vertexSize = mesh->attributes.size();
+			if (settings->weldVertices)
+				mesh->setWeldTolerance(WeldTolerance(settings->weldPosition, settings->weldNormalAngle, settings->weldUV, settings->weldColor));
+			return mesh;
+		}
+
+		MeshPart *addPart(Mesh * const &mesh, Node * const &node, const Material * const &material, const bool &hasUVs) {
+			MeshPart *part = new MeshPart();
+			part->primitiveType = PRIMITIVETYPE_TRIANGLES;
+			std::stringstream ss;
+			ss << node->id.c_str() << "_part" << (node->parts.size() + 1);
+			part->id = ss.str();
+			mesh->parts.push_back(part);
+			NodePart *nodePart = new NodePart();
+			nodePart->meshPart = part;
+			nodePart->material = material;
+			if (hasUVs)
+				nodePart->uvMapping.push_back(material->textures);
+			node->parts.push_back(nodePart);
+			return part;
+		}
+
+		/** Create the vertex of the corner, absent attributes are set to zero */
+		void getVertex(float * const &vertex, const int * const &corner, const bool &hasNormals, const bool &hasUVs) const {
+			unsigned int offset = 0;
+			memcpy(&vertex[offset], &positions[corner[0] * 3], 3 * sizeof(float));
+			offset += 3;
+			if (hasNormals) {
+				if (corner[2] >= 0)
+					memcpy(&vertex[offset], &normals[corner[2] * 3], 3 * sizeof(float));
+				else
+					vertex[offset] = vertex[offset + 1] = vertex[offset + 2] = 0.f;
+				offset += 3;
+			}
+			if (hasUVs) {
+				vertex[offset] = corner[1] >= 0 ? uvs[corner[1] * 2] : 0.f;
+				vertex[offset + 1] = corner[1] >= 0 ? uvs[corner[1] * 2 + 1] : 0.f;
+				if (settings->flipV)
+					vertex[offset + 1] = 1.f - vertex[offset + 1];
+			}
+		}
+
+		void calcBoundingSphere(const Mesh * const &mesh, MeshPart * const &part) {
+			part->bounds.calcSphere();
+			for (std::vector<unsigned short>::const_iterator itr = part->indices.begin(); itr != part->indices.end(); ++itr)
+				part->bounds.extSphere(&mesh->vertices[(*itr) * mesh->vertexSize]);
+		}
+
+		static inline bool isSpace(const char &c) {
+			return c == ' ' || c == '\t';
+		}
+
+		static inline void skipSpace(const char *&p, const char * const &end) {
+			while (p < end && isSpace(*p))
+				p++;
+		}
+
+		/** The remainder of the line without leading and trailing white space */
+		static std::string trim(const char *p, const char *end) {
+			skipSpace(p, end);
+			while (end > p && isSpace(end[-1]))
+				end--;
+			return std::string(p, end);
+		}
+
+		static int parseInt(const char *&p, const char * const &end) {
+			const bool negative = p < end && *p == '-';
+			if (negative || (p < end && *p == '+'))
+				p++;
+			int result = 0;
+			for (; p < end && *p >= '0' && *p <= '9'; p++)
+				result = result * 10 + (*p - '0');
+			return negative ? -result : result;
+		}
+
+		/** Parse a decimal floating point number, independent of the locale */
+		static float parseFloat(const char *&p, const char * const &end) {
+			const bool negative = p < end && *p == '-';
+			if (negative || (p < end && *p == '+'))
+				p++;
+			double result = 0.;
+			for (; p < end && *p >= '0' && *p <= '9'; p++)
+				result = result * 10. + (double)(*p - '0');
+			if (p < end && *p == '.') {
+				double scale = 0.1;
+				for (p++; p < end && *p >= '0' && *p <= '9'; p++, scale *= 0.1)
+					result += (double)(*p - '0') * scale;
+			}
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				p++;
+				result *= pow(10., (double)parseInt(p, end));
+			}
+			skipSpace(p, end);
+			return (float)(negative ? -result : result);
+		}
+
+		/** Parse (at most) count values, missing values are set to zero */
+		static void parseFloats(std::vector<float> &out, const char *p, const char * const &end, const unsigned int &count) {
+			for (unsigned int i = 0; i < count; i++)
+				out.push_back(p < end ? parseFloat(p, end) : 0.f);
+		}
+	};
+} }
+
+#endif //FBXCONV_READERS_OBJREADER_H
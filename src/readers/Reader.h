@@ -27,8 +27,18 @@ using namespace fbxconv::modeldata;
 namespace fbxconv {
 namespace readers {
 
+/** Receives each mesh as soon as the reader completed it, the reader doesn't change the mesh afterwards */
+struct MeshListener {
+	virtual ~MeshListener() {}
+	virtual void meshCompleted(Mesh * const &mesh) = 0;
+};
+
 class Reader {
 public:
+	/** Notified when a mesh is completed, a reader doesn't reuse completed meshes when set (can be null) */
+	MeshListener *meshListener;
+
+	Reader() : meshListener(0) {}
 	virtual ~Reader() {}
 	virtual bool load(Settings *settings) = 0;
 	virtual bool convert(Model * const &model) = 0;
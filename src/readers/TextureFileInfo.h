@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_READERS_TEXTUREFILEINFO_H
+#define FBXCONV_READERS_TEXTUREFILEINFO_H
+
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include "../modeldata/Material.h"
+#include "../Settings.h"
+#include "../log/log.h"
+
+using namespace fbxconv::modeldata;
+
+namespace fbxconv {
+namespace readers {
+	struct TextureFileInfo {
+		std::string path;
+		// The file generated for this texture (e.g. an atlas page) to read the texture from, empty to use the original file
+		std::string source;
+		// The uv bounds of this texture that are actually used (x1, y1, x2, y2)
+		float bounds[4];
+		// The number of nodes that use this texture
+		unsigned int nodeCount;
+		// The material textures that reference this texture
+		std::vector<Material::Texture *> textures;
+		TextureFileInfo() : nodeCount(0) {
+			memset(bounds, -1, sizeof(float) * 4);
+		}
+
+		// Whether the uv bounds are set, which is only the case if the texture is used by a mesh
+		inline bool hasBounds() const {
+			return *(int*)&bounds[0] != -1 && *(int*)&bounds[1] != -1 && *(int*)&bounds[2] != -1 && *(int*)&bounds[3] != -1;
+		}
+
+		// Find the file referenced by the model, which is either the filename itself or a file with the same name within the directory
+		static std::string locate(const std::string &filename, const std::string &directory) {
+			FILE *file = fopen(filename.c_str(), "rb");
+			if (file) {
+				fclose(file);
+				return filename;
+			}
+			const std::string result = directory + filename.substr(filename.find_last_of("/\\") + 1);
+			file = fopen(result.c_str(), "rb");
+			if (file) {
+				fclose(file);
+				return result;
+			}
+			return std::string();
+		}
+
+		// Calculate the 64 bit FNV-1a hash and the size of the content of the file, returns false if the file can't be read
+		static bool hashFile(const std::string &filename, unsigned long long &hash, unsigned long long &size) {
+			FILE *file = fopen(filename.c_str(), "rb");
+			if (!file)
+				return false;
+			static const size_t bufferSize = 64 * 1024;
+			unsigned char *buffer = new unsigned char[bufferSize];
+			hash = 14695981039346656037ULL;
+			size = 0;
+			size_t n;
+			while ((n = fread(buffer, 1, bufferSize, file)) > 0) {
+				for (size_t i = 0; i < n; i++)
+					hash = (hash ^ buffer[i]) * 1099511628211ULL;
+				size += n;
+			}
+			const bool result = !ferror(file);
+			delete[] buffer;
+			fclose(file);
+			return result;
+		}
+
+		// Whether the content of both files is equal, returns false if either file can't be read
+		static bool equalFiles(const std::string &filename1, const std::string &filename2) {
+			FILE *file1 = fopen(filename1.c_str(), "rb");
+			if (!file1)
+				return false;
+			FILE *file2 = fopen(filename2.c_str(), "rb");
+			if (!file2) {
+				fclose(file1);
+				return false;
+			}
+			static const size_t bufferSize = 64 * 1024;
+			unsigned char *buffer1 = new unsigned char[bufferSize];
+			unsigned char *buffer2 = new unsigned char[bufferSize];
+			bool result = true;
+			size_t n;
+			while (result && (n = fread(buffer1, 1, bufferSize, file1)) > 0)
+				result = fread(buffer2, 1, n, file2) == n && memcmp(buffer1, buffer2, n) == 0;
+			result = result && !ferror(file1) && !ferror(file2) && fgetc(file2) == EOF;
+			delete[] buffer1;
+			delete[] buffer2;
+			fclose(file1);
+			fclose(file2);
+			return result;
+		}
+
+		// The directory (including the trailing separator) of the file, or an empty string if none
+		static std::string getDirectory(const std::string &filename) {
+			const std::string::size_type pos = filename.find_last_of("/\\");
+			return pos == std::string::npos ? std::string() : filename.substr(0, pos + 1);
+		}
+	};
+
+	/** Called by the readers with all textures used by the model, to set the path of each texture and optionally process them */
+	typedef void (*TextureInfoCallback)(std::map<std::string, TextureFileInfo> &textures, const Settings * const &settings, fbxconv::log::Log * const &log);
+}
+}
+
+#endif //FBXCONV_READERS_TEXTUREFILEINFO_H
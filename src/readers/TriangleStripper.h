@@ -0,0 +1,182 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_READERS_TRIANGLESTRIPPER_H
+#define FBXCONV_READERS_TRIANGLESTRIPPER_H
+
+#include <vector>
+#include <algorithm>
+#include "../modeldata/Mesh.h"
+
+using namespace fbxconv::modeldata;
+
+namespace fbxconv {
+namespace readers {
+	/** Converts a list of triangles into a single triangle strip, the strips are joined by degenerate triangles, so no
+	 * primitive restart is needed. The strips are started at the first unused triangle in the original order, so a vertex
+	 * cache friendly order is mostly retained, and each strip is grown from the rotation of its first triangle that gives
+	 * the longest strip. The winding of every triangle is preserved, triangles without area are removed. */
+	class TriangleStripper {
+	public:
+		TriangleStripper(const std::vector<unsigned short> &indices) : stamp(0) {
+			init(indices);
+		}
+
+		/** Get the indices of the strip */
+		void getStrip(std::vector<unsigned short> &out) {
+			out.clear();
+			std::vector<unsigned short> strip;
+			const unsigned int count = (unsigned int)triangles.size() / 3;
+			for (unsigned int t = 0; t < count; t++) {
+				if (used[t])
+					continue;
+				unsigned int best = 0, bestLength = 0;
+				for (unsigned int r = 0; r < 3; r++) {
+					const unsigned int length = grow(t, r, strip, false);
+					if (length > bestLength) {
+						best = r;
+						bestLength = length;
+					}
+				}
+				grow(t, best, strip, true);
+				if (!out.empty()) {
+					// Degenerate triangles, the next strip must start at an even index to keep its winding
+					out.push_back(out.back());
+					if (out.size() % 2 == 0)
+						out.push_back(strip[0]);
+					out.push_back(strip[0]);
+				}
+				out.insert(out.end(), strip.begin(), strip.end());
+			}
+		}
+
+		/** Convert the triangle list part and its levels of detail to strips, each only if the strip has less indices.
+		 * Returns the number of parts converted. */
+		static unsigned int stripify(MeshPart * const &part) {
+			unsigned int result = convert(part) ? 1 : 0;
+			for (std::vector<MeshPart *>::iterator itr = part->lods.begin(); itr != part->lods.end(); ++itr)
+				if (convert(*itr))
+					result++;
+			return result;
+		}
+
+		/** Convert each triangle list part of the mesh to a strip if the strip has less indices. Returns the number of parts converted. */
+		static unsigned int stripify(Mesh * const &mesh) {
+			unsigned int result = 0;
+			for (std::vector<MeshPart *>::iterator itr = mesh->parts.begin(); itr != mesh->parts.end(); ++itr)
+				if (convert(*itr))
+					result++;
+			return result;
+		}
+
+	private:
+		/** The three indices of each triangle */
+		std::vector<unsigned short> triangles;
+		/** Whether each triangle is added to a strip */
+		std::vector<bool> used;
+		/** The stamp of the last trial strip each triangle is added to */
+		std::vector<unsigned int> marks;
+		unsigned int stamp;
+		/** The directed edges (from << 16 | to) of the triangles along with the triangle, sorted by edge */
+		std::vector<std::pair<unsigned int, unsigned int> > edges;
+
+		static bool convert(MeshPart * const &part) {
+			if (part->primitiveType != PRIMITIVETYPE_TRIANGLES || part->indices.size() % 3 != 0)
+				return false;
+			std::vector<unsigned short> strip;
+			TriangleStripper(part->indices).getStrip(strip);
+			if (strip.empty() || strip.size() >= part->indices.size())
+				return false;
+			part->indices.swap(strip);
+			part->primitiveType = PRIMITIVETYPE_TRIANGLESTRIP;
+			return true;
+		}
+
+		void init(const std::vector<unsigned short> &indices) {
+			triangles.reserve(indices.size());
+			for (std::vector<unsigned short>::size_type i = 0; i + 2 < indices.size(); i += 3) {
+				const unsigned short &a = indices[i], &b = indices[i + 1], &c = indices[i + 2];
+				if (a == b || b == c || c == a)
+					continue;
+				const unsigned int t = (unsigned int)triangles.size() / 3;
+				triangles.push_back(a);
+				triangles.push_back(b);
+				triangles.push_back(c);
+				edges.push_back(std::make_pair(edge(a, b), t));
+				edges.push_back(std::make_pair(edge(b, c), t));
+				edges.push_back(std::make_pair(edge(c, a), t));
+			}
+			std::sort(edges.begin(), edges.end());
+			used.assign(triangles.size() / 3, false);
+			marks.assign(triangles.size() / 3, 0);
+		}
+
+		inline static unsigned int edge(const unsigned short &from, const unsigned short &to) {
+			return ((unsigned int)from << 16) | (unsigned int)to;
+		}
+
+		/** Find the first (in the original order) available triangle with the directed edge, returns its index or -1 */
+		int find(const unsigned short &from, const unsigned short &to) const {
+			const unsigned int e = edge(from, to);
+			std::vector<std::pair<unsigned int, unsigned int> >::const_iterator itr =
+				std::lower_bound(edges.begin(), edges.end(), std::make_pair(e, 0u));
+			for (; itr != edges.end() && itr->first == e; ++itr)
+				if (!used[itr->second] && marks[itr->second] != stamp)
+					return (int)itr->second;
+			return -1;
+		}
+
+		/** The vertex of the triangle which isn't on the edge */
+		inline unsigned short opposite(const unsigned int &t, const unsigned short &from, const unsigned short &to) const {
+			const unsigned short * const v = &triangles[t * 3];
+			return (v[0] != from && v[0] != to) ? v[0] : ((v[1] != from && v[1] != to) ? v[1] : v[2]);
+		}
+
+		/** Grow a strip from the rotation of the triangle, the triangles are only marked as used if commit is true.
+		 * Returns the number of triangles in the strip. */
+		unsigned int grow(const unsigned int &t, const unsigned int &rotation, std::vector<unsigned short> &strip, const bool &commit) {
+			stamp++;
+			strip.clear();
+			for (unsigned int i = 0; i < 3; i++)
+				strip.push_back(triangles[t * 3 + (rotation + i) % 3]);
+			take(t, commit);
+			unsigned int length = 1;
+			for (;;) {
+				const unsigned short &x = strip[strip.size() - 2], &y = strip[strip.size() - 1];
+				// The odd triangles of a strip are wound in the opposite direction
+				const int next = (length % 2 == 0) ? find(x, y) : find(y, x);
+				if (next < 0)
+					break;
+				strip.push_back(opposite((unsigned int)next, x, y));
+				take((unsigned int)next, commit);
+				length++;
+			}
+			return length;
+		}
+
+		inline void take(const unsigned int &t, const bool &commit) {
+			if (commit)
+				used[t] = true;
+			else
+				marks[t] = stamp;
+		}
+	};
+}
+}
+
+#endif //FBXCONV_READERS_TRIANGLESTRIPPER_H
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_UTIL_MAPPEDFILE_H
+#define FBXCONV_UTIL_MAPPEDFILE_H
+
+#include <stddef.h>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fbxconv {
+namespace util {
+	/** Read only view of the content of a file, which is mapped into memory instead of read */
+	class MappedFile {
+	public:
+		const char *data;
+		size_t size;
+
+		MappedFile() : data(0), size(0) {}
+
+		~MappedFile() {
+			close();
+		}
+
+		/** Map the file, returns false if it can't be opened. An empty file is mapped to a null pointer with size 0. */
+		bool open(const char * const &filename) {
+			close();
+#ifdef _WIN32
+			HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+			LARGE_INTEGER length;
+			if (!GetFileSizeEx(file, &length)) {
+				CloseHandle(file);
+				return false;
+			}
+			size = (size_t)length.QuadPart;
+			if (size > 0) {
+				HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+				data = mapping ? (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+				if (mapping)
+					CloseHandle(mapping);
+			}
+			CloseHandle(file);
+#else
+			const int file = ::open(filename, O_RDONLY);
+			if (file < 0)
+				return false;
+			struct stat st;
+			if (fstat(file, &st) != 0) {
+				::close(file);
+				return false;
+			}
+			size = (size_t)st.st_size;
+			if (size > 0) {
+				void *ptr = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+				data = ptr == MAP_FAILED ? 0 : (const char *)ptr;
+			}
+			::close(file);
+#endif
+			if (size > 0 && data == 0) {
+				size = 0;
+				return false;
+			}
+			return true;
+		}
+
+		void close() {
+			if (data) {
+#ifdef _WIN32
+				UnmapViewOfFile(data);
+#else
+				munmap((void *)data, size);
+#endif
+			}
+			data = 0;
+			size = 0;
+		}
+
+	private:
+		MappedFile(const MappedFile &);
+		MappedFile &operator=(const MappedFile &);
+	};
+}
+}
+
+#endif //FBXCONV_UTIL_MAPPEDFILE_H
@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_UTIL_THREAD_H
+#define FBXCONV_UTIL_THREAD_H
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <sched.h>
+#endif
+
+namespace fbxconv {
+namespace util {
+	/** Atomically add the value and return the result */
+	inline long atomicAdd(volatile long * const &target, const long &value) {
+#ifdef _WIN32
+		return InterlockedExchangeAdd(target, value) + value;
+#else
+		return __sync_add_and_fetch(target, value);
+#endif
+	}
+
+	/** Atomically set the target to the value if it currently equals comparand, returns whether the value was set */
+	inline bool atomicCompareAndSwap(volatile long * const &target, const long &comparand, const long &value) {
+#ifdef _WIN32
+		return InterlockedCompareExchange(target, value, comparand) == comparand;
+#else
+		return __sync_bool_compare_and_swap(target, comparand, value);
+#endif
+	}
+
+	/** Full memory barrier, all reads and writes before it are visible to other threads before any after it */
+	inline void memoryBarrier() {
+#ifdef _WIN32
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	/** Give up the remainder of the time slice of the calling thread */
+	inline void yield() {
+#ifdef _WIN32
+		SwitchToThread();
+#else
+		sched_yield();
+#endif
+	}
+
+	/** Suspend the calling thread for (at least) the specified number of milliseconds */
+	inline void sleep(const unsigned int &milliseconds) {
+#ifdef _WIN32
+		Sleep(milliseconds);
+#else
+		usleep(milliseconds * 1000);
+#endif
+	}
+
+	/** The number of hardware threads available, at least 1 */
+	inline unsigned int hardwareThreads() {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+#else
+		const long n = sysconf(_SC_NPROCESSORS_ONLN);
+		return n > 0 ? (unsigned int)n : 1;
+#endif
+	}
+
+	class Mutex {
+	public:
+		Mutex() {
+#ifdef _WIN32
+			InitializeCriticalSection(&handle);
+#else
+			pthread_mutex_init(&handle, 0);
+#endif
+		}
+
+		~Mutex() {
+#ifdef _WIN32
+			DeleteCriticalSection(&handle);
+#else
+			pthread_mutex_destroy(&handle);
+#endif
+		}
+
+		inline void lock() {
+#ifdef _WIN32
+			EnterCriticalSection(&handle);
+#else
+			pthread_mutex_lock(&handle);
+#endif
+		}
+
+		inline void unlock() {
+#ifdef _WIN32
+			LeaveCriticalSection(&handle);
+#else
+			pthread_mutex_unlock(&handle);
+#endif
+		}
+	private:
+#ifdef _WIN32
+		CRITICAL_SECTION handle;
+#else
+		pthread_mutex_t handle;
+#endif
+		Mutex(const Mutex &);
+		Mutex &operator=(const Mutex &);
+	};
+
+	/** Locks the mutex for the lifetime of this object */
+	class ScopedLock {
+	public:
+		ScopedLock(Mutex &mutex) : mutex(mutex) {
+			mutex.lock();
+		}
+		~ScopedLock() {
+			mutex.unlock();
+		}
+	private:
+		Mutex &mutex;
+		ScopedLock(const ScopedLock &);
+		ScopedLock &operator=(const ScopedLock &);
+	};
+
+	/** Implement run() and call start() to execute it on a new thread, join() must be called before the object is destroyed */
+	class Thread {
+	public:
+		Thread() : started(false) {}
+
+		virtual ~Thread() {}
+
+		bool start() {
+#ifdef _WIN32
+			handle = CreateThread(0, 0, entry, this, 0, 0);
+			started = handle != 0;
+#else
+			started = pthread_create(&handle, 0, entry, this) == 0;
+#endif
+			return started;
+		}
+
+		void join() {
+			if (!started)
+				return;
+#ifdef _WIN32
+			WaitForSingleObject(handle, INFINITE);
+			CloseHandle(handle);
+#else
+			pthread_join(handle, 0);
+#endif
+			started = false;
+		}
+
+	protected:
+		virtual void run() = 0;
+
+	private:
+		bool started;
+#ifdef _WIN32
+		HANDLE handle;
+		static DWORD WINAPI entry(LPVOID arg) {
+			((Thread *)arg)->run();
+			return 0;
+		}
+#else
+		pthread_t handle;
+		static void *entry(void *arg) {
+			((Thread *)arg)->run();
+			return 0;
+		}
+#endif
+		Thread(const Thread &);
+		Thread &operator=(const Thread &);
+	};
+
+	/** A job which can be executed for multiple indices concurrently, see parallelFor */
+	struct Job {
+		virtual ~Job() {}
+		virtual void execute(const unsigned int &index) = 0;
+	};
+
+	/** Takes the next index of a job until all indices are taken */
+	struct JobWorker : public Thread {
+		Job *job;
+		volatile long *next;
+		long count;
+		JobWorker() : job(0), next(0), count(0) {}
+		void work() {
+			long index;
+			while ((index = atomicAdd(next, 1) - 1) < count)
+				job->execute((unsigned int)index);
+		}
+	protected:
+		virtual void run() {
+			work();
+		}
+	};
+
+	/** Execute the job for each index from 0 to count (exclusive) using the specified number of threads (0 for the
+	 * number of hardware threads), the calling thread is one of them. Returns when all indices are executed. */
+	inline void parallelFor(Job &job, const unsigned int &count, unsigned int threads = 0) {
+		if (threads == 0)
+			threads = hardwareThreads();
+		if (threads > count)
+			threads = count;
+		if (threads == 0)
+			return;
+		volatile long next = 0;
+		JobWorker *workers = new JobWorker[threads];
+		for (unsigned int i = 0; i < threads; i++) {
+			workers[i].job = &job;
+			workers[i].next = &next;
+			workers[i].count = (long)count;
+		}
+		for (unsigned int i = 1; i < threads; i++)
+			workers[i].start();
+		workers[0].work();
+		for (unsigned int i = 1; i < threads; i++)
+			workers[i].join();
+		delete[] workers;
+	}
+}
+}
+
+#endif //FBXCONV_UTIL_THREAD_H
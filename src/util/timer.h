@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright 2011 See AUTHORS file.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+#ifdef _MSC_VER
+#pragma once
+#endif //_MSC_VER
+#ifndef FBXCONV_UTIL_TIMER_H
+#define FBXCONV_UTIL_TIMER_H
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+namespace fbxconv {
+namespace util {
+	/** The time in seconds since an unspecified starting point, which isn't affected by changes of the system clock */
+	inline double seconds() {
+#ifdef _WIN32
+		LARGE_INTEGER frequency, counter;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+		return (double)counter.QuadPart / (double)frequency.QuadPart;
+#elif defined(__APPLE__)
+		mach_timebase_info_data_t info;
+		mach_timebase_info(&info);
+		return (double)mach_absolute_time() * (double)info.numer / (double)info.denom * 1e-9;
+#else
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+	}
+
+	/** Measures the elapsed time since it was created or last restarted */
+	struct Timer {
+		double start;
+
+		Timer() : start(seconds()) {}
+
+		inline void restart() {
+			start = seconds();
+		}
+
+		/** The elapsed time in seconds */
+		inline double elapsed() const {
+			return seconds() - start;
+		}
+	};
+}
+}
+
+#endif //FBXCONV_UTIL_TIMER_H